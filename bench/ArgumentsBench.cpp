@@ -0,0 +1,217 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utl/arguments.h"
+#include "utl/argumentschema.h"
+
+using std::string;
+using utl::Arguments;
+using utl::argr::boolean;
+using utl::argr::fromStream;
+using utl::argr::list;
+using utl::argr::number;
+using utl::argr::withUnit;
+
+
+/**
+ * Stores an argument list and the pointers which are passed as `argv`.
+ */
+class ArgList
+{
+public:
+	void add(const string &arg) { args.push_back(arg); }
+	int argc() const { return static_cast<int>(args.size()); }
+	const char **argv() {
+		ptrs.clear();
+		for (const string &arg : args)
+			ptrs.push_back(arg.c_str());
+		return ptrs.data();
+	}
+private:
+	std::vector<string> args = {"./bench"};
+	std::vector<const char*> ptrs;
+};
+
+static void registerOptions(Arguments &args, int count)
+{
+	for (int i = 0; i < count; ++i)
+		args.registerOption("--option" + std::to_string(i) + (i % 2 ? "=" : ""), i + 1);
+	args.registerOption("--verbose", 'v');
+	args.registerOption("--level=", 'l');
+}
+
+static void consume(Arguments &args)
+{
+	string param;
+	while (int opt = args.getNextOption()) {
+		if (args.hasParameter() || opt == 'l')
+			args.getNextArgument(param);
+		benchmark::DoNotOptimize(opt);
+	}
+	while (args.getNextArgument(param))
+		benchmark::DoNotOptimize(param);
+}
+
+
+// Parse time depending on the length of argv
+static void BM_argvLength(benchmark::State &state)
+{
+	ArgList list;
+	for (int i = 0; i < state.range(0); ++i) {
+		switch (i % 4) {
+		case 0: list.add("-v"); break;
+		case 1: list.add("--level=" + std::to_string(i)); break;
+		case 2: list.add("--verb"); break;
+		default: list.add("file" + std::to_string(i)); break;
+		}
+	}
+	const char **argv = list.argv();
+	for (auto _ : state) {
+		Arguments args(list.argc(), argv);
+		registerOptions(args, 8);
+		consume(args);
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_argvLength)->RangeMultiplier(4)->Range(4, 4096)->Complexity();
+
+// Parse time depending on the number of registered options
+static void BM_registeredOptions(benchmark::State &state)
+{
+	ArgList list;
+	for (int i = 0; i < 64; ++i)
+		list.add("--option" + std::to_string(i % state.range(0)));
+	const char **argv = list.argv();
+	for (auto _ : state) {
+		Arguments args(list.argc(), argv);
+		registerOptions(args, static_cast<int>(state.range(0)));
+		consume(args);
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_registeredOptions)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
+
+// Lookup of ambiguous prefixes depending on the length of the common prefix
+static void BM_ambiguityDepth(benchmark::State &state)
+{
+	string prefix = "--" + string(static_cast<std::size_t>(state.range(0)), 'a');
+	ArgList list;
+	for (int i = 0; i < 64; ++i)
+		list.add(prefix);
+	const char **argv = list.argv();
+	for (auto _ : state) {
+		Arguments args(list.argc(), argv);
+		for (int i = 0; i < 16; ++i)
+			args.registerOption(prefix + static_cast<char>('a' + i), i + 1);
+		while (int opt = args.getNextOption()) {
+			if (opt == -2)
+				benchmark::DoNotOptimize(args.getPossibleOptions().size());
+		}
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ambiguityDepth)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+// Parse time depending on the argument reader
+template<typename T, typename R>
+static void readParameters(benchmark::State &state, const string &value, R reader)
+{
+	ArgList list;
+	for (int i = 0; i < 64; ++i)
+		list.add("--value=" + value);
+	const char **argv = list.argv();
+	for (auto _ : state) {
+		Arguments args(list.argc(), argv);
+		args.registerOption("--value=", 1);
+		T param;
+		while (args.getNextOption() == 1)
+			args.getNextArgument(param, reader);
+		benchmark::DoNotOptimize(param);
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+
+static void BM_readerFromStream(benchmark::State &state)
+{
+	readParameters<int>(state, "12345", fromStream());
+}
+BENCHMARK(BM_readerFromStream);
+
+static void BM_readerWithUnit(benchmark::State &state)
+{
+	readParameters<long>(state, "12k", withUnit<long>{{"", 1}, {"k", 1000}, {"M", 1000000}});
+}
+BENCHMARK(BM_readerWithUnit);
+
+static void BM_readerList(benchmark::State &state)
+{
+	readParameters<std::vector<int>>(state, "1,2,3,4,5,6,7,8", list(number()));
+}
+BENCHMARK(BM_readerList);
+
+static void BM_readerBoolean(benchmark::State &state)
+{
+	readParameters<bool>(state, "false", boolean());
+}
+BENCHMARK(BM_readerBoolean);
+
+// Many short argument lists, as received by a command server
+static void BM_requestsRegister(benchmark::State &state)
+{
+	ArgList list;
+	list.add("--verb");
+	list.add("--level=3");
+	list.add("file");
+	const char **argv = list.argv();
+	for (auto _ : state) {
+		Arguments args(list.argc(), argv);
+		registerOptions(args, 32);
+		consume(args);
+	}
+}
+BENCHMARK(BM_requestsRegister);
+
+static void BM_requestsSharedIndex(benchmark::State &state)
+{
+	ArgList list;
+	list.add("--verb");
+	list.add("--level=3");
+	list.add("file");
+	const char **argv = list.argv();
+	utl::OptionIndex options;
+	for (int i = 0; i < 32; ++i)
+		options.insert("--option" + std::to_string(i) + (i % 2 ? "=" : ""), i + 1);
+	options.insert("--verbose", 'v');
+	options.insert("--level=", 'l');
+	Arguments args(list.argc(), argv, options);
+	for (auto _ : state) {
+		args.reset(list.argc(), argv);
+		consume(args);
+	}
+}
+BENCHMARK(BM_requestsSharedIndex);
+
+// One pass over argv with bound variables
+static void BM_schema(benchmark::State &state)
+{
+	ArgList list;
+	for (int i = 0; i < 16; ++i) {
+		list.add("-v");
+		list.add("--level=" + std::to_string(i));
+		list.add("file");
+	}
+	const char **argv = list.argv();
+	bool verbose;
+	int level;
+	utl::ArgumentSchema schema;
+	schema.flag("-v", verbose)
+	      .flag("--verbose", verbose)
+	      .option("--level=", level, number());
+	for (auto _ : state)
+		benchmark::DoNotOptimize(schema.parse(list.argc(), argv));
+	state.SetItemsProcessed(state.iterations() * 48);
+}
+BENCHMARK(BM_schema);
@@ -0,0 +1,97 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "utl/arguments.h"
+
+using std::string;
+using utl::argr::fromStream;
+using utl::argr::list;
+using utl::argr::number;
+using utl::argr::splitter;
+using utl::argr::withUnit;
+
+
+static const string INTEGERS[] = {"0", "-1", "42", "123456", "-2147483648"};
+static const string DOUBLES[] = {"0.0", "-1.1", "3.14159", "2.5e-3", "123456.789"};
+
+template<typename T, typename R>
+static void readAll(benchmark::State &state, const string (&input)[5], R reader)
+{
+	T value;
+	for (auto _ : state) {
+		for (const string &str : input) {
+			benchmark::DoNotOptimize(reader(str, value));
+			benchmark::DoNotOptimize(value);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * 5);
+}
+
+
+static void BM_fromStreamInt(benchmark::State &state)
+{
+	readAll<int>(state, INTEGERS, fromStream());
+}
+BENCHMARK(BM_fromStreamInt);
+
+static void BM_numberInt(benchmark::State &state)
+{
+	readAll<int>(state, INTEGERS, number());
+}
+BENCHMARK(BM_numberInt);
+
+static void BM_fromStreamDouble(benchmark::State &state)
+{
+	readAll<double>(state, DOUBLES, fromStream());
+}
+BENCHMARK(BM_fromStreamDouble);
+
+static void BM_numberDouble(benchmark::State &state)
+{
+	readAll<double>(state, DOUBLES, number());
+}
+BENCHMARK(BM_numberDouble);
+
+static void BM_withUnit(benchmark::State &state)
+{
+	withUnit<long> units{{"", 1}, {"k", 1000}, {"M", 1000 * 1000}};
+	const string input[] = {"0", "1k", "-5M", "250", "12k"};
+	readAll<long>(state, input, units);
+}
+BENCHMARK(BM_withUnit);
+
+static void BM_listLong(benchmark::State &state)
+{
+	string input;
+	for (int i = 0; i < 1000; ++i)
+		input += (i == 0 ? "" : ",") + std::to_string(i);
+	auto reader = list(number());
+	std::vector<int> value;
+	for (auto _ : state) {
+		value.clear();
+		benchmark::DoNotOptimize(reader(input, value));
+	}
+	state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_listLong);
+
+static void BM_splitterAnyOf(benchmark::State &state)
+{
+	string input;
+	for (int i = 0; i < 200; ++i)
+		input += "some/longer/path/element" + std::to_string(i) + (i % 2 ? ";" : ",");
+	splitter split = splitter::anyOf(",;", '\\');
+	string buffer;
+	for (auto _ : state) {
+		std::size_t n = 0;
+		split.split(input.data(), input.data() + input.size(), buffer,
+				[&n](const string &element) { n += element.size(); return true; });
+		benchmark::DoNotOptimize(n);
+	}
+	state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_splitterAnyOf);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,148 @@
+/*
+ * Fuzz harness for utl::Arguments.
+ *
+ * The input is split into lines. The first line contains the names of the
+ * options to register (separated by spaces), the remaining lines are the
+ * arguments. Besides crashes, the harness aborts on inputs which need more
+ * time or memory allocations than a linear bound allows.
+ *
+ * Built with Clang, the harness is linked against libFuzzer. Otherwise, it
+ * runs every file given on the command line, which is used to replay the
+ * regression corpus in fuzz/corpus.
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "utl/arguments.h"
+
+#ifndef UTL_FUZZ_ALLOCS_PER_BYTE
+#define UTL_FUZZ_ALLOCS_PER_BYTE 16
+#endif
+#ifndef UTL_FUZZ_MICROS_PER_BYTE
+#define UTL_FUZZ_MICROS_PER_BYTE 100
+#endif
+
+using std::string;
+
+static bool trackAllocations = false;
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size)
+{
+	if (trackAllocations)
+		++allocations;
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+static void run(const std::uint8_t *data, std::size_t size)
+{
+	std::vector<string> lines(1);
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] == '\n')
+			lines.emplace_back();
+		else if (data[i] != '\0')
+			lines.back().push_back(static_cast<char>(data[i]));
+	}
+
+	std::vector<const char*> argv;
+	argv.push_back("./fuzz");
+	for (std::size_t i = 1; i < lines.size(); ++i)
+		argv.push_back(lines[i].c_str());
+
+	utl::Arguments args(static_cast<int>(argv.size()), argv.data(), size % 2 == 0);
+	std::size_t pos = 0;
+	int key = 1;
+	while (pos < lines[0].size()) {
+		std::size_t end = lines[0].find(' ', pos);
+		if (end == string::npos)
+			end = lines[0].size();
+		if (end > pos)
+			args.registerOption(lines[0].substr(pos, end - pos), key++);
+		pos = end + 1;
+	}
+
+	// Only the parsing is measured, not the preparation of the input
+	allocations = 0;
+	trackAllocations = true;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::set<int> values;
+	string param;
+	while (int opt = args.getNextOption()) {
+		if (opt == -2) {
+			// The size of the result is not bounded by the argument
+			trackAllocations = false;
+			std::size_t candidates = args.getPossibleOptions().size();
+			trackAllocations = true;
+			if (candidates < 2)
+				std::abort();
+		} else if (args.hasParameter()) {
+			try {
+				args.getNextArgument(values, utl::argr::list(utl::argr::number()));
+			} catch (const std::exception&) {
+			}
+		}
+	}
+	while (args.getNextArgument(param))
+		;
+
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	trackAllocations = false;
+
+	std::size_t maxAllocations = 64 + UTL_FUZZ_ALLOCS_PER_BYTE * size;
+	long long maxMicros = 10000 + static_cast<long long>(UTL_FUZZ_MICROS_PER_BYTE * size);
+	if (allocations > maxAllocations) {
+		std::fprintf(stderr, "Too many allocations: %zu for %zu bytes\n", allocations, size);
+		std::abort();
+	}
+	if (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() > maxMicros) {
+		std::fprintf(stderr, "Parsing too slow for %zu bytes\n", size);
+		std::abort();
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size)
+{
+	run(data, size);
+	return 0;
+}
+
+#ifdef UTL_FUZZ_STANDALONE
+int main(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; ++i) {
+		std::ifstream file(argv[i], std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "Cannot open %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+		std::vector<char> input((std::istreambuf_iterator<char>(file)),
+				std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()),
+				input.size());
+	}
+	return EXIT_SUCCESS;
+}
+#endif
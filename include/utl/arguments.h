@@ -3,14 +3,28 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <locale>
 #include <map>
+#include <memory>
+#include <type_traits>
 #include <utility>
-#include <queue>
 #include <regex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+#include "utl/optionindex.h"
+
+#if __cplusplus >= 201703L
+#include <string_view>
+//! Defined if the std::string_view based functions of Arguments are available.
+#define UTL_HAS_STRING_VIEW 1
+#endif
 
 
 namespace utl {
@@ -57,6 +71,8 @@ namespace utl {
  *         The function where you can use stream readers.
  * @see argr::fromStream
  *         The default stream reader.
+ * @see argr::number
+ *         A faster reader for numbers.
  * @see argr::withUnit
  *         If you want to read a value while the user can use different units.
  */
@@ -90,6 +106,66 @@ struct fromStream {
 	}
 };
 
+/**
+ * @brief Reads numbers without using streams.
+ *
+ * This reader parses integers and floating point numbers directly from the
+ * string, without creating stream objects and without depending on the
+ * locale. It rejects the same inputs as fromStream (empty strings, prefixes
+ * and suffixes) and also rejects numbers which do not fit into the type of
+ * the parameter. In addition, integers may be given in hexadecimal (`0x1F`)
+ * or binary (`0b101`) notation.
+ *
+ * ```{.cpp}
+ * unsigned mask;
+ * args.getNextArgument(mask, utl::argr::number());
+ * ```
+ *
+ * @note
+ *     Unlike fromStream, leading whitespace is not skipped and unsigned
+ *     types do not accept negative numbers. `bool`, floating point types
+ *     wider than `double` and types which are neither integral nor floating
+ *     point types are read with the stream operator, so a `bool` is given
+ *     as `0` or `1`.
+ */
+struct number {
+	template<typename T>
+	bool operator() (const std::string &str, T &param) {
+		const char *first = str.data(), *last = first + str.size();
+		return parse(first, last, param, true) == last;
+	}
+
+	/**
+	 * @brief Parses a number at the beginning of the given range.
+	 *
+	 * @param first    The beginning of the range.
+	 * @param last     The end of the range.
+	 * @param param    The function will write the number to this parameter.
+	 * @param prefixes Whether `0x` and `0b` are accepted for integers.
+	 * @return A pointer behind the number, or `nullptr` if the range does not
+	 *         start with a valid number.
+	 */
+	template<typename T>
+	static const char *parse(const char *first, const char *last, T &param, bool prefixes) {
+		typedef std::integral_constant<int,
+				std::is_integral<T>::value && !std::is_same<T, bool>::value ? 0 :
+				std::is_floating_point<T>::value && sizeof(T) <= sizeof(double) ? 1 :
+				2> kind;
+		return parse(first, last, param, prefixes, kind());
+	}
+
+private:
+	template<typename T>
+	static const char *parse(const char *first, const char *last, T &param,
+			bool prefixes, std::integral_constant<int, 0>);
+	template<typename T>
+	static const char *parse(const char *first, const char *last, T &param,
+			bool prefixes, std::integral_constant<int, 1>);
+	template<typename T>
+	static const char *parse(const char *first, const char *last, T &param,
+			bool prefixes, std::integral_constant<int, 2>);
+};
+
 /**
  * @brief Allows the use of units.
  *
@@ -114,6 +190,8 @@ struct fromStream {
  *     The user can not eneter any number without a unit. If you want to accept
  *     pure numbers, you have to add an empty unit (``""``). Just like in the
  *     example. The user can always enter `0`, even if there is no empty unit.
+ *     Leading whitespace is skipped, but unsigned types do not accept
+ *     negative numbers.
  */
 template<typename F>
 class withUnit {
@@ -124,18 +202,19 @@ public:
 
 	template<typename T>
 	bool operator() (const std::string &str, T &param) {
-		std::istringstream stream(str);
-		stream >> param;
+		const char *first = str.data(), *last = first + str.size();
+		while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+			++first;
+		const char *end = number::parse(first, last, param, false);
 
-		std::string unit = static_cast<std::stringstream&>(
-					std::stringstream() << stream.rdbuf()).str();
-		auto it = unitMap.find(unit);
-
-		if (stream.fail()) {
+		if (end == nullptr) {
 			return false;
-		} else if (param == 0 && stream.peek() == EOF) {
+		} else if (param == 0 && end == last) {
 			return true;
-		} else if (it != unitMap.end()) {
+		}
+
+		auto it = unitMap.find(std::string(end, last));
+		if (it != unitMap.end()) {
 			param *= it->second;
 			return true;
 		} else {
@@ -177,6 +256,52 @@ struct boolean {
 	}
 };
 
+/**
+ * @brief Splits strings at delimiters.
+ *
+ * A splitter either splits at any character of a set (anyOf()) or at a
+ * sequence of characters (sequence()). Optionally, an escape character can be
+ * specified which makes the following character a part of the element. The
+ * search for delimiters processes 16 bytes at once with SSE2 (32 bytes with
+ * AVX2) if the set contains up to four characters.
+ *
+ * @see list
+ */
+class splitter {
+public:
+	splitter(char delimiter = ',', char escape = '\0');
+
+	static splitter anyOf(const std::string &delimiters, char escape = '\0');
+	static splitter sequence(const std::string &delimiter, char escape = '\0');
+
+	std::size_t count(const char *first, const char *last) const;
+
+	/**
+	 * @brief Calls @p func for every element of the given range.
+	 *
+	 * The elements are written to @p buffer, which is reused for every element
+	 * to avoid allocations. The function stops if @p func returns `false`.
+	 *
+	 * @return `false` if @p func returned `false`, `true` otherwise.
+	 */
+	template<typename F>
+	bool split(const char *first, const char *last, std::string &buffer, F func) const;
+
+private:
+	splitter(const std::string &delimiter, bool sequence, char escape);
+
+	const char *find(const char *first, const char *last) const;
+
+	std::string delimiter;
+	bool isSequence;
+	char escape;
+	// Characters which interrupt the search (delimiters and escape)
+	char special[4];
+	std::size_t specialCount;
+	bool isSpecial[256];
+	bool isDelimiter[256];
+};
+
 /**
  * @brief Helper class for utl::argr::list.
  *
@@ -185,35 +310,44 @@ struct boolean {
 template<typename R = fromStream>
 class list_helper {
 	template<typename C, typename V>
-	static void addTo(C &container, const V &value, decltype(container.insert(value))* = nullptr) {
+	static auto addTo(C &container, const V &value, int)
+			-> decltype(container.insert(value), void()) {
 		container.insert(value);
 	}
 	template<typename C, typename V>
-	static void addTo(C &container, const V &value) {
+	static void addTo(C &container, const V &value, long) {
 		container.push_back(value);
 	}
+	template<typename C>
+	static auto reserve(C &container, std::size_t n, int)
+			-> decltype(container.reserve(n), void()) {
+		container.reserve(container.size() + n);
+	}
+	template<typename C>
+	static void reserve(C &, std::size_t, long) {
+	}
 public:
-	list_helper(const R &reader = R(), char delimiter = ',') :
+	list_helper(const R &reader = R(), const splitter &delimiter = splitter()) :
 		reader(reader), delimiter(delimiter)
 	{}
 	template<typename T>
 	bool operator() (const std::string &str, T &param) {
 		if (str.empty())
 			return true;
-		std::size_t lastDeli = 0;
-		do {
-			std::size_t nextDeli = str.find_first_of(delimiter, lastDeli);
+		const char *first = str.data(), *last = first + str.size();
+		reserve(param, delimiter.count(first, last) + 1, 0);
+		std::string piece;
+		return delimiter.split(first, last, piece, [&](const std::string &element) {
 			typename T::value_type val;
-			if (!reader(str.substr(lastDeli, nextDeli - lastDeli), val))
+			if (!reader(element, val))
 				return false;
-			addTo(param, val);
-			lastDeli = nextDeli;
-		} while (lastDeli++ != std::string::npos);
-		return true;
+			addTo(param, val, 0);
+			return true;
+		});
 	}
 private:
 	R reader;
-	char delimiter;
+	splitter delimiter;
 };
 
 /**
@@ -232,14 +366,355 @@ private:
  * std::vector<bool> x;
  * args.getNextArgument(x, utl::argr::list(boolean(), ':'));
  * ```
+ *
+ * A splitter can be used for multiple delimiters, delimiters with multiple
+ * characters or escaping:
+ *
+ * ```
+ * std::vector<std::string> x;
+ * args.getNextArgument(x, utl::argr::list(fromStream(),
+ *         utl::argr::splitter::anyOf(",;", '\\')));
+ * ```
+ *
+ * Containers with a `reserve` function are reserved for the amount of
+ * delimiters before the elements are added.
  */
 template<typename R = fromStream>
 list_helper<R> list(const R &reader = R(), char delimiter = ',') {
+	return list_helper<R>(reader, splitter(delimiter));
+}
+
+template<typename R>
+list_helper<R> list(const R &reader, const splitter &delimiter) {
 	return list_helper<R>(reader, delimiter);
 }
 
+
+template<typename F>
+inline bool splitter::split(const char *first, const char *last, std::string &buffer, F func) const
+{
+	buffer.clear();
+	const char *p = first;
+	while (true) {
+		const char *q = find(p, last);
+		buffer.append(p, q);
+		if (q == last)
+			return func(static_cast<const std::string&>(buffer));
+
+		if (escape != '\0' && *q == escape) {
+			// Take the next character as it is
+			if (q + 1 != last) {
+				buffer.push_back(q[1]);
+				p = q + 2;
+			} else {
+				buffer.push_back(*q);
+				p = q + 1;
+			}
+		} else if (isSequence && (static_cast<std::size_t>(last - q) < delimiter.size() ||
+				delimiter.compare(0, std::string::npos, q, delimiter.size()) != 0)) {
+			// Only the first character of the delimiter matches
+			buffer.push_back(*q);
+			p = q + 1;
+		} else {
+			if (!func(static_cast<const std::string&>(buffer)))
+				return false;
+			buffer.clear();
+			p = q + (isSequence ? delimiter.size() : 1);
+		}
+	}
+}
+
+
+// Integral types
+template<typename T>
+inline const char *number::parse(const char *first, const char *last, T &param,
+		bool prefixes, std::integral_constant<int, 0>)
+{
+	typedef typename std::make_unsigned<T>::type U;
+
+	const char *p = first;
+	bool negative = false;
+	if (p != last && (*p == '+' || *p == '-'))
+		negative = (*p++ == '-');
+	if (negative && !std::is_signed<T>::value)
+		return nullptr;
+
+	unsigned base = 10;
+	if (prefixes && last - p > 2 && p[0] == '0') {
+		if (p[1] == 'x' || p[1] == 'X') {
+			base = 16;
+			p += 2;
+		} else if (p[1] == 'b' || p[1] == 'B') {
+			base = 2;
+			p += 2;
+		}
+	}
+
+	const U limit = negative
+			? static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + 1)
+			: static_cast<U>(std::numeric_limits<T>::max());
+	const char *digits = p;
+	U value = 0;
+	for (; p != last; ++p) {
+		unsigned d;
+		if (*p >= '0' && *p <= '9')
+			d = *p - '0';
+		else if (*p >= 'a' && *p <= 'z')
+			d = *p - 'a' + 10;
+		else if (*p >= 'A' && *p <= 'Z')
+			d = *p - 'A' + 10;
+		else
+			break;
+		if (d >= base)
+			break;
+		if (value > (limit - d) / base)
+			return nullptr; // overflow
+		value = static_cast<U>(value * base + d);
+	}
+	if (p == digits)
+		return nullptr;
+
+	param = static_cast<T>(negative ? static_cast<U>(0 - value) : value);
+	return p;
+}
+
+// Floating point types
+template<typename T>
+inline const char *number::parse(const char *first, const char *last, T &param,
+		bool, std::integral_constant<int, 1>)
+{
+	static const double POW10[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char *p = first;
+	bool negative = false;
+	if (p != last && (*p == '+' || *p == '-'))
+		negative = (*p++ == '-');
+
+	std::uint64_t mantissa = 0;
+	int significant = 0, exponent = 0;
+	bool anyDigit = false, exact = true;
+	for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+		anyDigit = true;
+		if (significant < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			significant += (mantissa != 0);
+		} else {
+			++exponent;
+			exact = exact && *p == '0';
+		}
+	}
+	if (p != last && *p == '.') {
+		for (++p; p != last && *p >= '0' && *p <= '9'; ++p) {
+			anyDigit = true;
+			if (significant < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				significant += (mantissa != 0);
+				--exponent;
+			} else {
+				exact = exact && *p == '0';
+			}
+		}
+	}
+	if (!anyDigit)
+		return nullptr;
+
+	if (p != last && (*p == 'e' || *p == 'E')) {
+		const char *q = p + 1;
+		bool negExp = false;
+		if (q != last && (*q == '+' || *q == '-'))
+			negExp = (*q++ == '-');
+		if (q != last && *q >= '0' && *q <= '9') {
+			int e = 0;
+			for (; q != last && *q >= '0' && *q <= '9'; ++q)
+				e = (e < 100000) ? e * 10 + (*q - '0') : e;
+			exponent += negExp ? -e : e;
+			p = q;
+		}
+	}
+
+	double value;
+	if (exact && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+		// Both operands are exact, so the result is correctly rounded
+		value = static_cast<double>(mantissa);
+		value = (exponent < 0) ? value / POW10[-exponent] : value * POW10[exponent];
+		if (negative)
+			value = -value;
+	} else {
+		// Rare case, let the standard library do the rounding
+		std::istringstream stream(std::string(first, p));
+		stream.imbue(std::locale::classic());
+		stream >> value;
+		if (stream.fail())
+			return nullptr;
+	}
+
+	if (value > std::numeric_limits<T>::max() || value < -std::numeric_limits<T>::max())
+		return nullptr; // overflow
+	param = static_cast<T>(value);
+	return p;
+}
+
+// Other types
+template<typename T>
+inline const char *number::parse(const char *first, const char *last, T &param,
+		bool, std::integral_constant<int, 2>)
+{
+	std::istringstream stream(std::string(first, last));
+	stream.imbue(std::locale::classic());
+	stream >> param;
+	if (stream.fail())
+		return nullptr;
+	if (stream.eof())
+		return last;
+	return first + static_cast<std::size_t>(stream.tellg());
+}
+
 } // namespace argr
 
+/**
+ * @brief Describes why an option or argument could not be parsed.
+ *
+ * The error is filled by Arguments::tryGetNextOption() and
+ * Arguments::tryGetNextArgument(). These functions do not throw exceptions,
+ * which makes them suitable to validate many argument lists.
+ */
+struct ArgumentError {
+	enum Kind {
+		//! There is no error.
+		NONE = 0,
+		//! The option is not registered.
+		UNKNOWN_OPTION,
+		//! The option is an abbreviation of multiple options.
+		AMBIGUOUS_OPTION,
+		//! There is no argument left.
+		MISSING_ARGUMENT,
+		//! The argument reader refused the argument.
+		INVALID_ARGUMENT
+	};
+
+	//! The kind of the error.
+	Kind kind = NONE;
+	//! The index of the offending token within `argv`.
+	std::size_t position = 0;
+	//! The option (like Arguments::getOptionName()) or the argument.
+	std::string token;
+	//! The options which could be meant for AMBIGUOUS_OPTION.
+	std::vector<std::string> candidates;
+
+	explicit operator bool() const { return kind != NONE; }
+	void clear();
+	std::string message() const;
+};
+
+/**
+ * @brief Exception which is thrown if an argument is invalid.
+ *
+ * @see Arguments::getNextArgument(T&,R)
+ */
+class ArgumentException : public std::runtime_error
+{
+public:
+	explicit ArgumentException(const ArgumentError &error) :
+		std::runtime_error(error.message()), err(error)
+	{}
+
+	//! Returns the details of the error.
+	const ArgumentError &error() const { return err; }
+
+private:
+	ArgumentError err;
+};
+
+/**
+ * @brief An entry of an OptionTable.
+ *
+ * @see OptionTable
+ */
+struct OptionDef {
+	//! The name of the option, just like for Arguments::registerOption().
+	const char *name;
+	//! The value which should be returned by Arguments::getNextOption().
+	int key;
+};
+
+/**
+ * @brief A table of options which is defined at compile time.
+ *
+ * Instead of registering every option with Arguments::registerOption() at
+ * runtime, you can define all options in a static array and pass it to the
+ * {@link Arguments::Arguments(int, const char *const[], const OptionTable&, bool)
+ * %constructor} of Arguments. The array has to be sorted by name (in the
+ * order of `strcmp`), which can be checked at compile time with isSorted().
+ * Options are then looked up with a binary search over the array, so creating
+ * the parser and looking up options does not allocate any memory.
+ *
+ * ```
+ * static constexpr utl::OptionDef OPTIONS[] = {
+ *     {"--debug",  OPT_DEBUG},
+ *     {"--quiet",  'q'},
+ *     {"--silent", 'q'}
+ * };
+ * static_assert(utl::OptionTable(OPTIONS).isSorted(),
+ *               "OPTIONS must be sorted by name");
+ *
+ * Arguments args(argc, argv, utl::OptionTable(OPTIONS));
+ * ```
+ *
+ * @note The table does not copy the array. The array has to outlive every
+ *       instance of Arguments which uses the table.
+ */
+class OptionTable
+{
+public:
+	constexpr OptionTable() :
+		defs(nullptr), count(0)
+	{}
+	template<std::size_t N>
+	constexpr OptionTable(const OptionDef (&defs)[N]) :
+		defs(defs), count(N)
+	{}
+	constexpr OptionTable(const OptionDef *defs, std::size_t count) :
+		defs(defs), count(count)
+	{}
+
+	constexpr std::size_t size() const { return count; }
+	constexpr const OptionDef *begin() const { return defs; }
+	constexpr const OptionDef *end() const { return defs + count; }
+
+	/**
+	 * @brief Checks whether the entries are sorted and unique by name.
+	 */
+	constexpr bool isSorted() const {
+		return count < 2 || isSortedRange(1, count);
+	}
+
+	const OptionDef *find(const char *name, std::size_t len) const;
+	const OptionDef *lowerBound(const char *prefix, std::size_t len) const;
+	const OptionDef *prefixEnd(const char *prefix, std::size_t len) const;
+
+private:
+	static constexpr bool less(const char *a, const char *b) {
+		return (*a == *b)
+				? (*a != '\0' && less(a + 1, b + 1))
+				: (static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b));
+	}
+
+	// Checks the pairs ending in [first, last). The range is halved, so the
+	// recursion depth stays logarithmic for large tables.
+	constexpr bool isSortedRange(std::size_t first, std::size_t last) const {
+		return (last - first == 1)
+				? less(defs[first - 1].name, defs[first].name)
+				: (isSortedRange(first, first + (last - first) / 2) &&
+						isSortedRange(first + (last - first) / 2, last));
+	}
+
+	const OptionDef *defs;
+	std::size_t count;
+};
+
 /**
  * @brief A class to parse command line arguments.
  *
@@ -301,33 +776,83 @@ class Arguments
 public:
 	Arguments(int argc, char const * const argv[]);
 	Arguments(int argc, char const * const argv[], bool strict);
+	Arguments(int argc, char const * const argv[], const OptionTable &table,
+			bool strict = false);
+	Arguments(int argc, char const * const argv[], const OptionIndex &index,
+			bool strict = false);
 	virtual ~Arguments() = default;
 
 	void registerOption(const std::string& opt, int key);
+	void reset(int argc, char const * const argv[]);
 
 	int getNextOption();
+	int tryGetNextOption(ArgumentError &error);
 	bool getNextArgument(std::string& param);
+#ifdef UTL_HAS_STRING_VIEW
+	bool getNextArgument(std::string_view& param);
+#endif
 	int getArgumentsLeft() const;
 
 	template<typename T, typename R = argr::fromStream>
 	bool getNextArgument(T &param, R reader = R());
+	template<typename T, typename R = argr::fromStream>
+	bool tryGetNextArgument(T &param, ArgumentError &error, R reader = R());
 
 	std::string getOptionName() const;
+#ifdef UTL_HAS_STRING_VIEW
+	std::string_view getOptionNameView() const;
+#endif
 	const std::map<std::string,int>& getPossibleOptions() const;
 	bool hasParameter() const;
 
+	//! Shells supported by writeCompletionScript().
+	enum CompletionShell {
+		BASH,
+		ZSH
+	};
+
+	std::vector<std::string> complete(const std::string &prefix) const;
+	bool handleCompletion(std::ostream &out, const char *trigger = "--complete") const;
+	void writeCompletionScript(std::ostream &out, CompletionShell shell,
+			const std::string &program) const;
+
 private:
-	const int argc;
-	char const * const * const argv;
-	std::map<std::string,int> optionMap;
+	const char *nextArgument();
+	int findLongOption(bool hasParam);
+	int findLongOptionInTable(bool hasParam);
+	int findShortOption();
+	const OptionIndex &options() const;
+	const char *currentOption() const;
+	void setOptionName(const char *name);
+
+	int argc;
+	char const * const *argv;
+	// created by the first registerOption(), so instances with a shared
+	// index or a table do not allocate one. Copies share it until one of
+	// them registers another option.
+	std::shared_ptr<OptionIndex> optionIndex;
+	const OptionIndex *sharedIndex = nullptr;
+	OptionTable optionTable;
 	bool strictRefuse;
 
 	std::size_t idxArg = 1, idxChar = 0;
-	std::queue<std::string> params;
+	// Positions of the last option and argument within argv
+	std::size_t idxOption = 0, idxArgument = 0;
+	std::vector<std::size_t> params;
+	std::size_t idxParam = 0;
 	bool noOptions = false;
 
-	std::string currentOption;
-	std::map<std::string,int> possibleOptions;
+	// The name of the current option points into argv or to a registered
+	// option, so it is never copied. Short options are kept in shortOption.
+	const char *optionName = nullptr;
+	std::size_t optionLength = 0;
+	char shortOption[2] = {'-', '\0'};
+	// The argument for the reader in tryGetNextArgument()
+	std::string argumentBuffer;
+	OptionIndex::Cursor ambiguousPrefix;
+	bool ambiguousParam = false;
+	mutable bool possibleOptionsValid = true;
+	mutable std::map<std::string,int> possibleOptions;
 };
 
 
@@ -361,7 +886,65 @@ inline Arguments::Arguments(int argc, char const * const argv[]) :
  */
 inline Arguments::Arguments(int argc, const char * const argv[], bool strict) :
 	argc(argc), argv(argv), strictRefuse(strict)
-{
+{	params.reserve(argc);
+}
+
+/**
+ * @brief Creates a new instance of Arguments which uses the options of a
+ * table defined at compile time.
+ *
+ * The options of the table are used instead of options registered with
+ * registerOption(). So registerOption() must not be used with this
+ * constructor.
+ *
+ * @param argc The amount of arguments.
+ * @param argv An array of all arguments. This array should contain @em `argc`
+ *             c-strings.
+ * @param table The options which are accepted.
+ * @param strict Whether *strict mode* should be enabled or not.
+ *
+ * @see OptionTable
+ */
+inline Arguments::Arguments(int argc, const char * const argv[],
+		const OptionTable &table, bool strict) :
+	argc(argc), argv(argv), optionTable(table), strictRefuse(strict)
+{	params.reserve(argc);
+}
+
+/**
+ * @brief Creates a new instance of Arguments which uses the options of an
+ * existing index.
+ *
+ * The index is not copied, so creating the instance is cheap. An index can
+ * be filled once and shared by many instances, even in multiple threads, as
+ * long as it is not changed anymore. registerOption() must not be used with
+ * this constructor.
+ *
+ * ```
+ * utl::OptionIndex options;
+ * options.insert("--quiet", 'q');
+ * options.insert("--debug", OPT_DEBUG);
+ *
+ * // For every request (in any thread)
+ * Arguments args(argc, argv, options);
+ * ```
+ *
+ * To avoid allocations for every argument list, an instance can also be
+ * reused with reset().
+ *
+ * @param argc The amount of arguments.
+ * @param argv An array of all arguments. This array should contain @em `argc`
+ *             c-strings.
+ * @param index The options which are accepted. The index has to outlive the
+ *              instance.
+ * @param strict Whether *strict mode* should be enabled or not.
+ *
+ * @see OptionIndex
+ */
+inline Arguments::Arguments(int argc, const char * const argv[],
+		const OptionIndex &index, bool strict) :
+	argc(argc), argv(argv), sharedIndex(&index), strictRefuse(strict)
+{	params.reserve(argc);
 }
 
 /**
@@ -392,7 +975,13 @@ inline Arguments::Arguments(int argc, const char * const argv[], bool strict) :
 inline void Arguments::registerOption(const std::string &opt, int key)
 {
 	assert(key > 0);
-	optionMap[opt] = key;
+	assert(optionTable.size() == 0);
+	assert(sharedIndex == nullptr);
+	if (!optionIndex)
+		optionIndex = std::make_shared<OptionIndex>();
+	else if (optionIndex.use_count() > 1)
+		optionIndex = std::make_shared<OptionIndex>(*optionIndex);
+	optionIndex->insert(opt, key);
 }
 
 /**
@@ -401,8 +990,31 @@ inline void Arguments::registerOption(const std::string &opt, int key)
  */
 inline int Arguments::getArgumentsLeft() const
 {
-	return (argc - idxArg) + params.size();
+	return (argc - idxArg) + (params.size() - idxParam);
+}
+
+#ifdef UTL_HAS_STRING_VIEW
+/**
+ * @brief Gets the next argument without copying it.
+ *
+ * This function works like getNextArgument(std::string&), but the argument is
+ * returned as view into the `argv` array given to the constructor. It is only
+ * available if the library is compiled with C++17 or newer.
+ *
+ * @param param The function will write the argument to this parameter.
+ * @return `false` if there is no argument left, `true` otherwise.
+ *
+ * @see getNextArgument(std::string&)
+ */
+inline bool Arguments::getNextArgument(std::string_view &param)
+{
+	const char *arg = nextArgument();
+	if (arg == nullptr)
+		return false;
+	param = arg;
+	return true;
 }
+#endif
 
 /**
  * @brief Gets the next argument while using an argument reader.
@@ -415,7 +1027,7 @@ inline int Arguments::getArgumentsLeft() const
  * @param param The function will write the argument to this parameter.
  * @param reader The argument reader which should be used.
  * @return `false` if there is no argument left, `true` otherwise.
- * @throws std::exception If the argument is not valid.
+ * @throws ArgumentException If the argument is not valid.
  *
  * @see getNextArgument(std::string&)
  *         Is used by this function.
@@ -425,14 +1037,50 @@ inline int Arguments::getArgumentsLeft() const
 template<typename T, typename R>
 inline bool Arguments::getNextArgument(T &param, R reader)
 {
-	std::string str;
-	if (!getNextArgument(str))
+	ArgumentError error;
+	if (tryGetNextArgument(param, error, reader))
+		return true;
+	if (error.kind == ArgumentError::MISSING_ARGUMENT)
 		return false;
+	throw ArgumentException(error);
+}
 
-	if (reader(str, param))
+/**
+ * @brief Gets the next argument while using an argument reader without
+ * throwing exceptions.
+ *
+ * Works like getNextArgument(T&,R), but an invalid argument is reported in
+ * @p error. The argument is passed to the reader in a buffer which is reused
+ * for all arguments, so only an argument longer than the previous ones
+ * allocates.
+ *
+ * @param param The function will write the argument to this parameter.
+ * @param error The function will write the error to this parameter, its
+ *              kind is either ArgumentError::MISSING_ARGUMENT or
+ *              ArgumentError::INVALID_ARGUMENT.
+ * @param reader The argument reader which should be used.
+ * @return `true` if the argument was read, `false` otherwise.
+ *
+ * @see getNextArgument(T&,R)
+ */
+template<typename T, typename R>
+inline bool Arguments::tryGetNextArgument(T &param, ArgumentError &error, R reader)
+{
+	error.clear();
+	const char *arg = nextArgument();
+	if (arg == nullptr) {
+		error.kind = ArgumentError::MISSING_ARGUMENT;
+		error.position = argc;
+		return false;
+	}
+
+	argumentBuffer.assign(arg);
+	if (reader(argumentBuffer, param))
 		return true;
-	else
-		throw std::exception(); // TODO use another exception type
+	error.kind = ArgumentError::INVALID_ARGUMENT;
+	error.position = idxArgument;
+	error.token = argumentBuffer;
+	return false;
 }
 
 /**
@@ -447,9 +1095,26 @@ inline bool Arguments::getNextArgument(T &param, R reader)
  */
 inline std::string Arguments::getOptionName() const
 {
-	return currentOption;
+	return std::string(currentOption(), optionLength);
 }
 
+#ifdef UTL_HAS_STRING_VIEW
+/**
+ * @brief Returns the name of the current option without copying it.
+ *
+ * The returned view is only valid until the next call of getNextOption() or
+ * registerOption().
+ *
+ * @return The name of the current option.
+ *
+ * @see getOptionName()
+ */
+inline std::string_view Arguments::getOptionNameView() const
+{
+	return std::string_view(currentOption(), optionLength);
+}
+#endif
+
 /**
  * @brief Returns possible options if getNextOption() has returned `-2`.
  *
@@ -471,6 +1136,14 @@ inline std::string Arguments::getOptionName() const
  */
 inline const std::map<std::string, int> &Arguments::getPossibleOptions() const
 {
+	if (!possibleOptionsValid) {
+		possibleOptions.clear();
+		options().forEachCandidate(ambiguousPrefix, ambiguousParam,
+				[this](const std::string &name, int key) {
+			possibleOptions.emplace(name, key);
+		});
+		possibleOptionsValid = true;
+	}
 	return possibleOptions;
 }
 
@@ -488,6 +1161,25 @@ inline bool Arguments::hasParameter() const
 	return idxChar > 0;
 }
 
+inline const OptionIndex &Arguments::options() const
+{
+	static const OptionIndex emptyIndex;
+	if (sharedIndex)
+		return *sharedIndex;
+	return optionIndex ? *optionIndex : emptyIndex;
+}
+
+inline const char *Arguments::currentOption() const
+{
+	return optionName ? optionName : shortOption;
+}
+
+inline void Arguments::setOptionName(const char *name)
+{
+	optionName = name;
+	optionLength = std::strlen(name);
+}
+
 } // namespace utl
 
 #endif // UTL_ARGUMENTS_H
@@ -0,0 +1,180 @@
+#ifndef UTL_ARGUMENTSCHEMA_H
+#define UTL_ARGUMENTSCHEMA_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utl/arguments.h"
+#include "utl/configsource.h"
+
+
+namespace utl {
+
+/**
+ * @brief Binds options directly to variables.
+ *
+ * Instead of dispatching every option returned by Arguments::getNextOption()
+ * in a `switch` statement, the options can be declared once together with
+ * the variable they are written to and the {@link argr argument reader}
+ * which parses their parameter:
+ *
+ * ```
+ * bool verbose = false;
+ * long size = 0;
+ * std::vector<int> ids;
+ *
+ * utl::ArgumentSchema schema;
+ * schema.flag("--verbose", verbose)
+ *       .flag("-v", verbose)
+ *       .option("--size=", size, utl::argr::withUnit<long>{{"k", 1000}})
+ *       .option("--ids=", ids, utl::argr::list(utl::argr::number()));
+ *
+ * std::vector<std::string> files = schema.parse(argc, argv);
+ * ```
+ *
+ * The names are the same as for Arguments::registerOption(). The type of the
+ * reader is part of the binding, so the reader is created once and called
+ * without any further dispatch. parse() walks over the arguments once. The
+ * key of an option is the index of its binding, so the binding is found
+ * without a lookup after the option has been resolved.
+ *
+ * The options are looked up in *strict mode*. Unknown or ambiguous options,
+ * missing parameters and parameters which are rejected by their reader
+ * cause an ArgumentException. For a missing parameter, the token of the
+ * ArgumentError is the name of the option.
+ *
+ * Long options which are not given on the command line can be taken from
+ * environment variables or a config file, see ConfigSource:
+ *
+ * ```
+ * utl::ConfigSource config;
+ * config.setEnvironmentPrefix("MYAPP_");
+ * config.setFile("/etc/myapp.conf");
+ * std::vector<std::string> files = schema.parse(argc, argv, config);
+ * ```
+ */
+class ArgumentSchema
+{
+public:
+	ArgumentSchema() = default;
+
+	ArgumentSchema &flag(const std::string &name, bool &target);
+
+	template<typename T, typename R = argr::fromStream>
+	ArgumentSchema &option(const std::string &name, T &target, R reader = R());
+
+	std::vector<std::string> parse(int argc, char const * const argv[]);
+	std::vector<std::string> parse(int argc, char const * const argv[],
+			ConfigSource &fallback);
+
+private:
+	class Binding {
+	public:
+		explicit Binding(const std::string &name) : name(name) {}
+		virtual ~Binding() = default;
+		virtual void read(Arguments &args) = 0;
+		virtual void read(const std::string &value) = 0;
+		virtual const void *target() const = 0;
+
+		const std::string name;
+	};
+
+	class FlagBinding;
+	template<typename T, typename R>
+	class ReaderBinding;
+
+	void add(Binding *binding);
+	std::vector<std::string> parse(int argc, char const * const argv[],
+			ConfigSource *fallback);
+
+	std::vector<std::unique_ptr<Binding>> bindings;
+	// Sorted by name, the key is the index in bindings plus one
+	std::vector<OptionDef> table;
+};
+
+
+class ArgumentSchema::FlagBinding : public Binding
+{
+public:
+	FlagBinding(const std::string &name, bool &target) :
+		Binding(name), flagTarget(target)
+	{}
+	void read(Arguments &) override {
+		flagTarget = true;
+	}
+	void read(const std::string &value) override {
+		if (!argr::boolean()(value, flagTarget))
+			throw std::runtime_error("Invalid value for option " + name + ": " + value);
+	}
+	const void *target() const override {
+		return &flagTarget;
+	}
+private:
+	bool &flagTarget;
+};
+
+template<typename T, typename R>
+class ArgumentSchema::ReaderBinding : public Binding
+{
+public:
+	ReaderBinding(const std::string &name, T &target, const R &reader) :
+		Binding(name), readerTarget(target), reader(reader)
+	{}
+	void read(Arguments &args) override {
+		ArgumentError error;
+		auto call = [this](const std::string &str, T &target) {
+			return reader(str, target);
+		};
+		if (args.tryGetNextArgument(readerTarget, error, call))
+			return;
+		if (error.kind == ArgumentError::MISSING_ARGUMENT)
+			error.token = name;
+		throw ArgumentException(error);
+	}
+	void read(const std::string &value) override {
+		if (!reader(value, readerTarget))
+			throw std::runtime_error("Invalid parameter for option " + name + ": " + value);
+	}
+	const void *target() const override {
+		return &readerTarget;
+	}
+private:
+	T &readerTarget;
+	R reader;
+};
+
+
+/**
+ * @brief Binds an option without parameter to @p target.
+ *
+ * @p target is set to `true` if the option is given.
+ *
+ * @throws std::invalid_argument If an option with this name is bound already.
+ */
+inline ArgumentSchema &ArgumentSchema::flag(const std::string &name, bool &target)
+{
+	add(new FlagBinding(name, target));
+	return *this;
+}
+
+/**
+ * @brief Binds an option with parameter to @p target.
+ *
+ * The parameter of the option is parsed with @p reader and written to
+ * @p target. If the option is given multiple times, the reader is called
+ * for every occurrence.
+ *
+ * @throws std::invalid_argument If an option with this name is bound already.
+ */
+template<typename T, typename R>
+inline ArgumentSchema &ArgumentSchema::option(const std::string &name, T &target, R reader)
+{
+	add(new ReaderBinding<T, R>(name, target, reader));
+	return *this;
+}
+
+} // namespace utl
+
+#endif // UTL_ARGUMENTSCHEMA_H
@@ -0,0 +1,94 @@
+#ifndef UTL_CONFIGSOURCE_H
+#define UTL_CONFIGSOURCE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+
+namespace utl {
+
+/**
+ * @brief Provides option values from environment variables and a config file.
+ *
+ * A ConfigSource is used by ArgumentSchema::parse(int, const char *const[], ConfigSource&)
+ * for options which are not given on the command line. The value of an
+ * option is taken from the environment first and from the config file
+ * second.
+ *
+ * The key of an option is its name without leading dashes and without a
+ * trailing `'='`. For the environment, the key is converted to upper case,
+ * dashes are replaced by underscores and the prefix is prepended. The option
+ * `--log-level=` is looked up as `MYAPP_LOG_LEVEL` with the prefix `MYAPP_`
+ * for example.
+ *
+ * The config file contains one `key = value` pair per line. Whitespace
+ * around keys and values is ignored, and lines starting with `#` are
+ * comments. If a key occurs multiple times, the first occurrence is used.
+ * A missing file is treated like an empty file.
+ *
+ * The file is only opened when a key is not found in the environment. It is
+ * then indexed in one pass, and all lookups, including those of keys which
+ * are not in the file, are answered from the index. The indexed keys point
+ * into the mapped file, so indexing does not copy them.
+ */
+class ConfigSource
+{
+public:
+	ConfigSource() = default;
+	~ConfigSource();
+
+	ConfigSource(const ConfigSource&) = delete;
+	ConfigSource &operator=(const ConfigSource&) = delete;
+
+	void setEnvironmentPrefix(const std::string &prefix);
+	void setFile(const std::string &path);
+
+	bool lookup(const std::string &key, std::string &value);
+
+	static std::string keyOf(const std::string &optionName);
+
+private:
+	// A key in the file, which is not copied
+	struct Key {
+		const char *data;
+		std::size_t size;
+
+		bool operator==(const Key &other) const;
+	};
+	struct KeyHash {
+		std::size_t operator()(const Key &key) const;
+	};
+
+	bool lookupFile(const std::string &key, std::string &value);
+	void open();
+	void buildIndex();
+	void close();
+
+	std::string envPrefix;
+	bool hasEnvPrefix = false;
+
+	std::string path;
+	bool opened = false;
+	const char *data = nullptr;
+	std::size_t size = 0;
+	// Value ranges of all keys in the file
+	std::unordered_map<Key, std::pair<std::size_t, std::size_t>, KeyHash> index;
+};
+
+
+/**
+ * @brief Enables the lookup in environment variables.
+ *
+ * The prefix is prepended to the names of the variables. It may be empty.
+ */
+inline void ConfigSource::setEnvironmentPrefix(const std::string &prefix)
+{
+	envPrefix = prefix;
+	hasEnvPrefix = true;
+}
+
+} // namespace utl
+
+#endif // UTL_CONFIGSOURCE_H
@@ -0,0 +1,132 @@
+#ifndef UTL_BUFFEREDLOGCONTEXT_H
+#define UTL_BUFFEREDLOGCONTEXT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utl/log/loglevel.h"
+#include "utl/log/logsite.h"
+
+
+namespace utl {
+namespace log {
+
+class Logger;
+
+/**
+ * @brief Holds back the records of a unit of work until it fails.
+ *
+ * While a context is attached to a thread, every record logged by this
+ * thread with a level below the flush level is stored in the context instead
+ * of being passed to the handlers. When a record with at least the flush
+ * level is logged, the stored records are passed on first, followed by the
+ * record itself and all later records. If nothing fails, the stored records
+ * are discarded at the end of the scope without being formatted or handled.
+ *
+ * ```
+ * void handleRequest(const Request &request)
+ * {
+ *     utl::log::BufferedLogContext context;
+ *     utl::fine("Request %s", request.id().c_str());  // held back
+ *     // ...
+ *     utl::warning("Request failed");  // passes both records on
+ * }
+ * ```
+ *
+ * The context is attached to the thread which creates it. If the work moves
+ * to another thread, call detach() on the old thread and attach() on the new
+ * one. A context must not be used by two threads at the same time.
+ *
+ * Records are only stored if the level of the logger allows them. The
+ * stored records keep their logger alive, so it is not evicted from the
+ * registry before they are passed on. If the stored records exceed the
+ * capacity, further records are dropped.
+ */
+class BufferedLogContext
+{
+public:
+	explicit BufferedLogContext(const LogLevel &flushLevel = LogLevel::WARNING,
+			std::size_t capacity = 64 * 1024);
+	~BufferedLogContext();
+
+	BufferedLogContext(const BufferedLogContext&) = delete;
+	BufferedLogContext &operator=(const BufferedLogContext&) = delete;
+
+	static BufferedLogContext *current();
+
+	void attach();
+	void detach();
+	bool isAttached() const;
+
+	const LogLevel &getFlushLevel() const;
+	bool isFlushed() const;
+	std::size_t size() const;
+	std::size_t getDroppedRecords() const;
+
+	void flush();
+	void discard();
+
+	bool buffer(const Logger &logger, const LogLevel &level, const std::string &msg,
+			const LogSite *site);
+
+private:
+	struct Entry {
+		std::shared_ptr<const Logger> logger;
+		LogLevel level;
+		const LogSite *site;
+		std::size_t offset;
+		std::size_t nameLength;
+		std::size_t messageLength;
+		std::size_t contextLength;
+	};
+
+	const LogLevel mFlushLevel;
+	const std::size_t mCapacity;
+	std::vector<Entry> mEntries;
+	std::string mArena;
+	std::size_t mDropped;
+	bool mFlushed;
+
+	bool mAttached;
+	BufferedLogContext *mPrevious;
+
+	static thread_local BufferedLogContext *currentContext;
+};
+
+
+inline BufferedLogContext *BufferedLogContext::current()
+{
+	return currentContext;
+}
+
+inline bool BufferedLogContext::isAttached() const
+{
+	return mAttached;
+}
+
+inline const LogLevel &BufferedLogContext::getFlushLevel() const
+{
+	return mFlushLevel;
+}
+
+inline bool BufferedLogContext::isFlushed() const
+{
+	return mFlushed;
+}
+
+inline std::size_t BufferedLogContext::size() const
+{
+	return mEntries.size();
+}
+
+inline std::size_t BufferedLogContext::getDroppedRecords() const
+{
+	return mDropped;
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_BUFFEREDLOGCONTEXT_H
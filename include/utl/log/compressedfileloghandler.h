@@ -0,0 +1,48 @@
+#ifndef UTL_COMPRESSEDFILELOGHANDLER_H
+#define UTL_COMPRESSEDFILELOGHANDLER_H
+
+#include <cstddef>
+#include <string>
+
+#include "utl/log/compressedwriter.h"
+#include "utl/log/loghandler.h"
+#include "utl/log/logrecord.h"
+#include "utl/log/patternformatter.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Writes records into a compressed log file.
+ *
+ * The records are formatted with a PatternFormatter (without colors) and
+ * written through a CompressedWriter. The file can be read with
+ * CompressedReader.
+ */
+class CompressedFileLogHandler : public LogHandler
+{
+public:
+	explicit CompressedFileLogHandler(const std::string &path,
+			std::size_t blockSize = 64 * 1024,
+			const std::string &pattern = PatternFormatter::DEFAULT_PATTERN);
+	virtual ~CompressedFileLogHandler() noexcept;
+
+	void flush();
+
+	virtual void publish(const LogRecord &record) override;
+
+protected:
+	virtual void publishBatch(const LogRecord *records, std::size_t count) override;
+	virtual std::string format(const LogRecord &record) const;
+
+private:
+	const PatternFormatter mFormatter;
+	CompressedWriter mWriter;
+
+};
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_COMPRESSEDFILELOGHANDLER_H
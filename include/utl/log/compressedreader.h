@@ -0,0 +1,48 @@
+#ifndef UTL_COMPRESSEDREADER_H
+#define UTL_COMPRESSEDREADER_H
+
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Reads files written by CompressedWriter.
+ *
+ * The file is read block by block, so only one block has to be kept in
+ * memory. Blocks can be skipped without decompressing them.
+ *
+ * ```
+ * utl::log::CompressedReader reader("app.log.ulz");
+ * reader.copyTo(std::cout);
+ * ```
+ *
+ * @see CompressedWriter
+ */
+class CompressedReader
+{
+public:
+	explicit CompressedReader(const std::string &path);
+	virtual ~CompressedReader() = default;
+
+	bool good() const;
+
+	bool nextBlock(std::string &text);
+	bool skipBlock();
+	void copyTo(std::ostream &stream);
+
+private:
+	bool readHeader(bool &compressed, std::size_t &rawSize, std::size_t &storedSize);
+
+	std::ifstream mFile;
+	std::string mBuffer;
+};
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_COMPRESSEDREADER_H
@@ -0,0 +1,74 @@
+#ifndef UTL_COMPRESSEDWRITER_H
+#define UTL_COMPRESSEDWRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Writes a file in independently compressed blocks.
+ *
+ * Data given to write() is collected until a block is full. Full blocks are
+ * compressed and written to the file on a background thread, so the caller
+ * only pays for copying the data. Every block starts with a lz::BlockHeader,
+ * which keeps the file seekable and lets new blocks be appended to an
+ * existing file. Use CompressedReader to read the file back.
+ *
+ * @see CompressedReader
+ * @see CompressedFileLogHandler
+ */
+class CompressedWriter
+{
+public:
+	explicit CompressedWriter(const std::string &path, std::size_t blockSize = 64 * 1024);
+	virtual ~CompressedWriter() noexcept;
+
+	CompressedWriter(const CompressedWriter&) = delete;
+	CompressedWriter &operator=(const CompressedWriter&) = delete;
+
+	void write(const char *data, std::size_t size);
+	void write(const std::string &data);
+	void flush();
+
+	bool good() const;
+	std::size_t getBytesIn() const;
+	std::size_t getBytesOut() const;
+
+private:
+	void run();
+
+	std::ofstream mFile;
+	const std::size_t mBlockSize;
+
+	std::string mBlock;
+	std::deque<std::string> mQueue;
+	bool mBusy = false;
+	bool mStop = false;
+	bool mGood;
+	std::size_t mBytesIn = 0;
+	std::size_t mBytesOut = 0;
+
+	mutable std::mutex mMutex;
+	std::condition_variable mWork;
+	std::condition_variable mIdle;
+	std::thread mThread;
+};
+
+
+inline void CompressedWriter::write(const std::string &data)
+{
+	write(data.data(), data.size());
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_COMPRESSEDWRITER_H
@@ -1,23 +1,36 @@
 #ifndef UTL_CONSOLELOGHANDLER_H
 #define UTL_CONSOLELOGHANDLER_H
 
+#include <string>
+
 #include "utl/log/loghandler.h"
 #include "utl/log/logrecord.h"
+#include "utl/log/patternformatter.h"
 
 
 namespace utl {
 namespace log {
 
+/**
+ * @brief Writes records to `stderr`.
+ *
+ * The records are formatted with a PatternFormatter. If `stderr` is a
+ * terminal, the level and the logger name are colored.
+ */
 class ConsoleLogHandler : public LogHandler
 {
 public:
-	ConsoleLogHandler();
+	explicit ConsoleLogHandler(const std::string &pattern = PatternFormatter::DEFAULT_PATTERN);
 	virtual ~ConsoleLogHandler() noexcept;
 
 	virtual void publish(const LogRecord &record) override;
 
+protected:
+	virtual void publishBatch(const LogRecord *records, std::size_t count) override;
+
 private:
 	bool mIsTTY;
+	PatternFormatter mFormatter;
 
 };
 
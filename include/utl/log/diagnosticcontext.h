@@ -0,0 +1,89 @@
+#ifndef UTL_DIAGNOSTICCONTEXT_H
+#define UTL_DIAGNOSTICCONTEXT_H
+
+#include <cstddef>
+#include <string>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Key/value pairs which are attached to every record of a thread.
+ *
+ * This is a mapped diagnostic context (MDC). The pairs are pushed with a
+ * Guard, which removes them again at the end of the scope. Every record
+ * which passes the level of its logger gets a copy of the pairs of the
+ * current thread in LogRecord::context, rendered like
+ * `request=42 tenant=acme`.
+ *
+ * ```
+ * void handleRequest(const Request &request)
+ * {
+ *     utl::log::DiagnosticContext::Guard guard("request", request.id());
+ *     utl::info("Started");  // [INFO][logger][request=42] Started
+ * }
+ * ```
+ *
+ * The pairs are stored in a fixed-size buffer of the thread, so pushing and
+ * popping never allocates memory. If there are more than #MAX_ENTRIES pairs
+ * or their text exceeds #MAX_LENGTH characters, further pairs are ignored.
+ * The key should be a string literal, it is not copied.
+ */
+class DiagnosticContext
+{
+public:
+	static const std::size_t MAX_ENTRIES = 16;
+	static const std::size_t MAX_LENGTH = 480;
+
+	class Guard;
+
+	static bool push(const char *key, const char *value, std::size_t length);
+	static void pop();
+
+	static std::size_t depth();
+	static std::size_t length();
+	static bool get(const std::string &key, std::string &value);
+	static void appendTo(std::string &str);
+
+	DiagnosticContext() = delete;
+};
+
+/**
+ * @brief Pushes a pair onto the context of the thread for its lifetime.
+ */
+class DiagnosticContext::Guard
+{
+public:
+	Guard(const char *key, const std::string &value);
+	Guard(const char *key, const char *value, std::size_t length);
+	~Guard();
+
+	Guard(const Guard&) = delete;
+	Guard &operator=(const Guard&) = delete;
+
+private:
+	bool mPushed;
+};
+
+
+inline DiagnosticContext::Guard::Guard(const char *key, const std::string &value) :
+	mPushed(DiagnosticContext::push(key, value.data(), value.size()))
+{
+}
+
+inline DiagnosticContext::Guard::Guard(const char *key, const char *value, std::size_t length) :
+	mPushed(DiagnosticContext::push(key, value, length))
+{
+}
+
+inline DiagnosticContext::Guard::~Guard()
+{
+	if (mPushed)
+		DiagnosticContext::pop();
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_DIAGNOSTICCONTEXT_H
@@ -0,0 +1,171 @@
+#ifndef UTL_FLIGHTRECORDERLOGHANDLER_H
+#define UTL_FLIGHTRECORDERLOGHANDLER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "utl/log/loghandler.h"
+#include "utl/log/loglevel.h"
+#include "utl/log/logrecord.h"
+#include "utl/log/logsite.h"
+#include "utl/log/stacktrace.h"
+
+class FlightRecorderLogHandlerTest;
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Keeps the most recent records in memory and dumps them on demand.
+ *
+ * Every thread writes its records into its own ring buffer, which is
+ * assigned when the thread publishes its first record. The records are not
+ * formatted, storing one only copies the logger name, the message, the
+ * diagnostic context and the frames of the stack trace. When
+ * a ring buffer is full, the oldest records are overwritten. Writing does
+ * not take any locks.
+ *
+ * The records of all threads are merged in timestamp order and passed to the
+ * target handler when
+ *
+ *   * a record with at least the dump level (SEVERE by default) arrives,
+ *   * dump() is called, or
+ *   * a signal enabled with dumpOnSignal() is received. In this case, the
+ *     records are written directly to a file descriptor.
+ *
+ * Every record is dumped only once. A handler supports up to #MAX_THREADS
+ * threads at the same time, records of further threads are dropped. When a
+ * thread exits, its ring buffer is given to the next thread which needs
+ * one, so its records are kept until they are overwritten.
+ *
+ * ```
+ * auto console = std::make_shared<ConsoleLogHandler>();
+ * auto recorder = std::make_shared<FlightRecorderLogHandler>(console);
+ * Logger::getRoot().setLevel(LogLevel::FINE);
+ * Logger::getRoot().addHandler(recorder);
+ * ```
+ */
+class FlightRecorderLogHandler : public LogHandler
+{
+public:
+	static const std::size_t MAX_THREADS = 64;
+
+	explicit FlightRecorderLogHandler(std::shared_ptr<LogHandler> target,
+			std::size_t bytesPerThread = 64 * 1024);
+	virtual ~FlightRecorderLogHandler() noexcept;
+
+	FlightRecorderLogHandler(const FlightRecorderLogHandler&) = delete;
+	FlightRecorderLogHandler &operator=(const FlightRecorderLogHandler&) = delete;
+
+	const LogLevel &getDumpLevel() const;
+	void setDumpLevel(const LogLevel &level);
+	std::size_t getDroppedRecords() const;
+
+	void dump();
+	void dump(int fd);
+
+	static void dumpOnSignal(FlightRecorderLogHandler *handler, int signal, int fd = 2);
+
+	virtual void publish(const LogRecord &record) override;
+
+private:
+	friend class ::FlightRecorderLogHandlerTest;
+
+	struct Entry;
+	struct Ring;
+	struct View;
+
+	Ring *ring();
+	template<typename F>
+	void merge(View *views, std::size_t count, F func);
+	template<typename Writer>
+	static void copyText(Writer &out, const View &view, std::uint64_t pos, std::size_t length);
+
+	const std::uint64_t mId;
+	const std::shared_ptr<LogHandler> mTarget;
+	const std::size_t mBytesPerThread;
+	LogLevel mDumpLevel;
+
+	std::atomic<Ring*> mRings[MAX_THREADS];
+	std::shared_ptr<Ring> mRingOwners[MAX_THREADS];
+	std::atomic<std::size_t> mRingCount;
+	std::atomic<std::size_t> mDropped;
+	std::atomic<std::int64_t> mDumpedUntil;
+	const std::chrono::steady_clock::time_point mEpoch;
+	std::mutex mDumpMutex;
+
+};
+
+
+/**
+ * The fixed part of a record in a ring buffer, followed by the logger name,
+ * the message, the diagnostic context and the frames of the stack trace.
+ */
+struct FlightRecorderLogHandler::Entry {
+	std::uint32_t size;
+	std::int32_t level;
+	std::int64_t time;
+	std::uint32_t nameLength;
+	std::uint32_t messageLength;
+	std::uint32_t contextLength;
+	std::uint32_t frameCount;
+	const LogSite *site;
+};
+
+/**
+ * The records of a ring buffer which have not been dumped yet.
+ *
+ * The ring may be overwritten while it is read (by dump(int)), so peek()
+ * checks that an entry fits into the view before it is used.
+ */
+struct FlightRecorderLogHandler::View {
+	void copyOut(std::uint64_t at, void *dst, std::size_t n) const {
+		std::size_t offset = static_cast<std::size_t>(at % capacity);
+		std::size_t first = std::min(n, capacity - offset);
+		std::memcpy(dst, data + offset, first);
+		std::memcpy(static_cast<char*>(dst) + first, data, n - first);
+	}
+	bool peek(Entry &entry) const {
+		if (pos >= end || end - pos > capacity || end - pos < sizeof(Entry))
+			return false;
+		copyOut(pos, &entry, sizeof(entry));
+		return entry.size >= sizeof(Entry) && entry.size <= end - pos &&
+				entry.frameCount <= StackTrace::MAX_DEPTH &&
+				sizeof(Entry) + static_cast<std::uint64_t>(entry.nameLength) +
+				entry.messageLength + entry.contextLength +
+				entry.frameCount * sizeof(void*) == entry.size;
+	}
+
+	const char *data;
+	std::size_t capacity;
+	std::uint64_t pos;
+	std::uint64_t end;
+};
+
+
+inline const LogLevel &FlightRecorderLogHandler::getDumpLevel() const
+{
+	return mDumpLevel;
+}
+
+inline void FlightRecorderLogHandler::setDumpLevel(const LogLevel &level)
+{
+	mDumpLevel = level;
+}
+
+inline std::size_t FlightRecorderLogHandler::getDroppedRecords() const
+{
+	return mDropped.load(std::memory_order_relaxed);
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_FLIGHTRECORDERLOGHANDLER_H
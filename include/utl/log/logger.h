@@ -1,22 +1,29 @@
 #ifndef UTL_LOGGER_H
 #define UTL_LOGGER_H
 
+#include <atomic>
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "utl/log/bufferedlogcontext.h"
+#include "utl/log/diagnosticcontext.h"
 #include "utl/log/loghandler.h"
 #include "utl/log/loglevel.h"
 #include "utl/log/logrecord.h"
+#include "utl/log/logsite.h"
+#include "utl/log/stacktrace.h"
 #include "utl/utils.h"
 
 
 namespace utl {
 namespace log {
 
-class Logger
+class Logger : public std::enable_shared_from_this<Logger>
 {
 public:
 	Logger();
@@ -28,43 +35,78 @@ public:
 	static std::shared_ptr<Logger> getRootP();
 	static std::shared_ptr<Logger> getP(const std::string &name);
 
+	static std::size_t sweep();
+	static std::size_t getRegistryLimit();
+	static void setRegistryLimit(std::size_t limit);
+	static std::size_t getRegistrySize();
+
 	const LogLevel &getLevel() const;
 	void setLevel(const LogLevel &level);
+	bool isLoggable(const LogLevel &level) const;
+	LogLevel getStackTraceLevel() const;
+	void setStackTraceLevel(const LogLevel &level);
 	void addHandler(std::shared_ptr<LogHandler> handler);
 	void removeHandler(std::shared_ptr<LogHandler> handler);
 
 	void log(const LogLevel &level, const std::string &msg) const;
 	template <typename... Args>
 	void log(const LogLevel &level, const std::string &format, const Args&... args) const;
+	void log(const LogLevel &level, const LogSite &site, const std::string &msg) const;
+	template <typename... Args>
+	void log(const LogLevel &level, const LogSite &site, const std::string &format,
+			const Args&... args) const;
 
 protected:
 	void log(const LogRecord &record) const;
+	void log(const LogRecord *records, std::size_t count) const;
 
 private:
+	friend class BufferedLogContext;
+	friend class ScopedTimer;
+
+	typedef std::list<std::shared_ptr<Logger>> LoggerList;
+
+	void dispatch(const LogLevel &level, const std::string &msg, const LogSite *site) const;
+	std::shared_ptr<const Logger> share() const;
+
+	static std::size_t evict(std::size_t count);
+
 	LogLevel mLevel;
+	LogLevel mStackTraceLevel;
 	std::string mName;
 	std::shared_ptr<Logger> mParent;
 	std::unordered_set<std::shared_ptr<LogHandler>> mHandlers;
+	// set once the level or the handlers were changed, which pins the
+	// logger in the registry
+	std::atomic<bool> mConfigured;
 	mutable std::mutex mMutex;
 
 	static Logger root;
 	static std::shared_ptr<Logger> rootSharedPtr;
-	static std::unordered_map<std::string, std::shared_ptr<Logger>> globalLoggers;
+	// the registered loggers, the most recently used first
+	static LoggerList recentLoggers;
+	static std::unordered_map<std::string, LoggerList::iterator> globalLoggers;
+	static std::size_t registryLimit;
 	static std::mutex staticMutex;
 };
 
 
 inline Logger::Logger() :
-	mLevel(LogLevel::CONFIG)
+	mLevel(LogLevel::CONFIG),
+	mStackTraceLevel(LogLevel::OFF),
+	mConfigured(false)
 {
 }
 
 inline Logger::Logger(const std::shared_ptr<Logger> &parent) :
 	mLevel(LogLevel::CONFIG),
-	mParent(parent)
+	mStackTraceLevel(LogLevel::OFF),
+	mParent(parent),
+	mConfigured(false)
 {
 	if (mParent != nullptr) {
 		mLevel = mParent->mLevel;
+		mStackTraceLevel = mParent->mStackTraceLevel;
 	}
 }
 
@@ -73,6 +115,18 @@ inline Logger &Logger::getRoot()
 	return Logger::root;
 }
 
+/**
+ * @brief Returns the logger with the name @p name, which is created if
+ * necessary.
+ *
+ * If loggers are evicted from the registry (see sweep() and
+ * setRegistryLimit()), the reference is only valid as long as the logger is
+ * configured or referenced elsewhere. Use getP() to keep it alive.
+ *
+ * Once a registry limit is set, any call of get() or getP() may evict
+ * loggers, so get() is not safe to use while other threads create loggers.
+ * Hold the logger with getP() instead.
+ */
 inline Logger &Logger::get(const std::string &name)
 {
 	return *Logger::getP(name);
@@ -83,25 +137,6 @@ inline std::shared_ptr<Logger> Logger::getRootP()
 	return Logger::rootSharedPtr;
 }
 
-inline std::shared_ptr<Logger> Logger::getP(const std::string &name)
-{
-	// use global logger if the name is empty
-	if (name.empty())
-		return Logger::rootSharedPtr;
-	// lock to secure the map (globalLoggers)
-	// TODO use a lock which supports concurrent reads?
-	std::lock_guard<std::mutex> lock(staticMutex);
-	// get the locker
-	auto ret = globalLoggers.emplace(name, std::make_shared<Logger>(rootSharedPtr));
-	std::shared_ptr<Logger> &logger = ret.first->second;
-	if (ret.second) {
-		// locker is new, setup
-		logger->mName = name;
-		// TODO setup from configuration, if available
-	}
-	return logger;
-}
-
 inline const LogLevel &Logger::getLevel() const
 {
 	std::lock_guard<std::mutex> lock(mMutex);
@@ -112,12 +147,43 @@ inline void Logger::setLevel(const LogLevel &level)
 {
 	std::lock_guard<std::mutex> lock(mMutex);
 	mLevel = level;
+	mConfigured = true;
+}
+
+inline bool Logger::isLoggable(const LogLevel &level) const
+{
+	return level >= mLevel;
+}
+
+inline LogLevel Logger::getStackTraceLevel() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStackTraceLevel;
+}
+
+/**
+ * @brief Captures a StackTrace for every record at or above @p level.
+ *
+ * The trace only contains the return addresses, they are resolved when a
+ * handler writes the record. Stack traces are disabled by default
+ * (LogLevel::OFF). Loggers which are created afterwards inherit the level.
+ */
+inline void Logger::setStackTraceLevel(const LogLevel &level)
+{
+	// The first capture loads the unwinder, which should not happen while
+	// logging a severe record
+	if (level != LogLevel::OFF)
+		StackTrace().capture();
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStackTraceLevel = level;
+	mConfigured = true;
 }
 
 inline void Logger::addHandler(std::shared_ptr<LogHandler> handler)
 {
 	std::lock_guard<std::mutex> lock(mMutex);
 	mHandlers.insert(handler);
+	mConfigured = true;
 }
 
 inline void Logger::removeHandler(std::shared_ptr<LogHandler> handler)
@@ -128,22 +194,57 @@ inline void Logger::removeHandler(std::shared_ptr<LogHandler> handler)
 
 inline void Logger::log(const LogLevel &level, const std::string &msg) const
 {
-	if (level < mLevel)
+	if (isLoggable(level))
+		dispatch(level, msg, nullptr);
+}
+
+template <typename... Args>
+inline void Logger::log(const LogLevel &level, const std::string &format, const Args&... args) const
+{
+	this->log(level, utl::format(format, args...));
+}
+
+/**
+ * @brief Logs a message of the call site @p site.
+ *
+ * This function is used by the `utl_log` macros, the record points to the
+ * descriptor of the call site.
+ */
+inline void Logger::log(const LogLevel &level, const LogSite &site, const std::string &msg) const
+{
+	if (isLoggable(level))
+		dispatch(level, msg, &site);
+}
+
+template <typename... Args>
+inline void Logger::log(const LogLevel &level, const LogSite &site, const std::string &format,
+		const Args&... args) const
+{
+	if (isLoggable(level))
+		dispatch(level, utl::format(format, args...), &site);
+}
+
+inline void Logger::dispatch(const LogLevel &level, const std::string &msg,
+		const LogSite *site) const
+{
+	BufferedLogContext *context = BufferedLogContext::current();
+	if (context != nullptr && context->buffer(*this, level, msg, site))
 		return;
 
 	LogRecord record;
 	record.loggerName = mName;
 	record.level = level;
 	record.message = msg;
+	record.site = site;
+	if (level >= mStackTraceLevel) {
+		std::shared_ptr<StackTrace> trace = std::make_shared<StackTrace>();
+		trace->capture();
+		record.stackTrace = std::move(trace);
+	}
+	DiagnosticContext::appendTo(record.context);
 	this->log(record);
 }
 
-template <typename... Args>
-inline void Logger::log(const LogLevel &level, const std::string &format, const Args&... args) const
-{
-	this->log(level, utl::format(format, args...));
-}
-
 inline void Logger::log(const LogRecord &record) const
 {
 	// TODO use lock which supports concurrent reads?
@@ -158,6 +259,23 @@ inline void Logger::log(const LogRecord &record) const
 	}
 }
 
+/**
+ * @brief Passes several records to the handlers of this logger and its
+ * parents, every handler gets all records in one call.
+ */
+inline void Logger::log(const LogRecord *records, std::size_t count) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	for (const auto &handler : mHandlers) {
+		handler->handleBatch(records, count);
+	}
+
+	if (this->mParent != nullptr) {
+		this->mParent->log(records, count);
+	}
+}
+
 } // namespace log
 } // namespace utl
 
@@ -1,6 +1,8 @@
 #ifndef UTL_LOGHANDLER_H
 #define UTL_LOGHANDLER_H
 
+#include <cstddef>
+
 #include "utl/log/loglevel.h"
 #include "utl/log/logrecord.h"
 
@@ -18,9 +20,11 @@ public:
 	void setLevel(const LogLevel &level);
 
 	void handle(const LogRecord &record);
+	void handleBatch(const LogRecord *records, std::size_t count);
 
 protected:
 	virtual void publish(const LogRecord &record) = 0;
+	virtual void publishBatch(const LogRecord *records, std::size_t count);
 
 private:
 	LogLevel level;
@@ -49,6 +53,38 @@ inline void LogHandler::handle(const LogRecord &record)
 		publish(record);
 }
 
+/**
+ * @brief Handles @p count records at once.
+ *
+ * The records which pass the level of the handler are passed to
+ * publishBatch(), a consecutive run of them in one call.
+ */
+inline void LogHandler::handleBatch(const LogRecord *records, std::size_t count)
+{
+	const LogRecord *end = records + count;
+	while (records != end) {
+		while (records != end && records->level < this->getLevel())
+			++records;
+		const LogRecord *first = records;
+		while (records != end && records->level >= this->getLevel())
+			++records;
+		if (records != first)
+			publishBatch(first, static_cast<std::size_t>(records - first));
+	}
+}
+
+/**
+ * @brief Publishes several records.
+ *
+ * The default implementation calls publish() for every record. Handlers
+ * override it to share system calls, locks or buffers between the records.
+ */
+inline void LogHandler::publishBatch(const LogRecord *records, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		publish(records[i]);
+}
+
 } // namespace log
 } // namespace utl
 
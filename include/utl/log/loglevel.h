@@ -2,14 +2,31 @@
 #define UTL_LOGLEVEL_H
 
 #include <climits>
+#include <cstddef>
 #include <ostream>
-#include <memory>
 #include <string>
 
 
 namespace utl {
 namespace log {
 
+/**
+ * @brief The severity of a record.
+ *
+ * A level is only an integer, so it can be copied freely and created in
+ * constant expressions. The predefined levels are constant initialized and
+ * can be used during static initialization.
+ *
+ * The names of the predefined levels are built in. Other levels can be given
+ * a name with registerName() (or the constructor taking a name, which throws
+ * if the name cannot be registered), which is then used for every level with
+ * the same value:
+ *
+ * ```
+ * constexpr utl::log::LogLevel TRACE(200);
+ * utl::log::LogLevel::registerName(200, "TRACE");
+ * ```
+ */
 class LogLevel final
 {
 public:
@@ -23,83 +40,78 @@ public:
 	static const LogLevel SEVERE;
 	static const LogLevel OFF;
 
-	explicit LogLevel(int value) noexcept;
-	LogLevel(int value, std::string name);
-	explicit operator int() const noexcept;
+	//! Maximum number of names which can be registered.
+	static const std::size_t MAX_REGISTERED_NAMES = 32;
 
-	bool operator==(const LogLevel &other) const noexcept;
-	bool operator!=(const LogLevel &other) const noexcept;
-	bool operator>=(const LogLevel &other) const noexcept;
-	bool operator<=(const LogLevel &other) const noexcept;
-	bool operator>(const LogLevel &other) const noexcept;
-	bool operator<(const LogLevel &other) const noexcept;
+	constexpr explicit LogLevel(int value) noexcept;
+	LogLevel(int value, const std::string &name);
+	constexpr explicit operator int() const noexcept;
 
-	friend std::ostream &operator<< (std::ostream &stream, LogLevel level);
+	const char *getName() const noexcept;
+	static bool registerName(int value, const std::string &name);
 
-private:
-	struct Data {
-		std::string mName;
-	};
+	constexpr bool operator==(const LogLevel &other) const noexcept;
+	constexpr bool operator!=(const LogLevel &other) const noexcept;
+	constexpr bool operator>=(const LogLevel &other) const noexcept;
+	constexpr bool operator<=(const LogLevel &other) const noexcept;
+	constexpr bool operator>(const LogLevel &other) const noexcept;
+	constexpr bool operator<(const LogLevel &other) const noexcept;
 
+private:
 	int mValue;
-	std::shared_ptr<Data> mData;
 
 };
 
 
-inline LogLevel::LogLevel(int value) noexcept :
+constexpr LogLevel::LogLevel(int value) noexcept :
 	mValue(value)
 {
 }
 
-inline LogLevel::LogLevel(int value, std::string name) :
-	mValue(value),
-	mData(std::make_shared<Data>())
-{
-	mData->mName = name;
-}
-
-inline LogLevel::operator int() const noexcept
+constexpr LogLevel::operator int() const noexcept
 {
 	return mValue;
 }
 
-inline bool LogLevel::operator==(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator==(const LogLevel &other) const noexcept
 {
 	return (this->mValue == other.mValue);
 }
 
-inline bool LogLevel::operator!=(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator!=(const LogLevel &other) const noexcept
 {
 	return (this->mValue != other.mValue);
 }
 
-inline bool LogLevel::operator>=(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator>=(const LogLevel &other) const noexcept
 {
 	return (this->mValue >= other.mValue);
 }
 
-inline bool LogLevel::operator<=(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator<=(const LogLevel &other) const noexcept
 {
 	return (this->mValue <= other.mValue);
 }
 
-inline bool LogLevel::operator>(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator>(const LogLevel &other) const noexcept
 {
 	return (this->mValue > other.mValue);
 }
 
-inline bool LogLevel::operator<(const LogLevel &other) const noexcept
+constexpr bool LogLevel::operator<(const LogLevel &other) const noexcept
 {
 	return (this->mValue < other.mValue);
 }
 
+/**
+ * @brief Writes the name of the level, or its value if it has no name.
+ */
 inline std::ostream &operator<<(std::ostream &stream, LogLevel level)
 {
-	if (level.mData && !level.mData->mName.empty())
-		return stream << level.mData->mName;
+	if (const char *name = level.getName())
+		return stream << name;
 	else
-		return stream << level.mValue;
+		return stream << static_cast<int>(level);
 }
 
 } // namespace log
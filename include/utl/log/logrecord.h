@@ -1,9 +1,12 @@
 #ifndef UTL_LOGRECORD_H
 #define UTL_LOGRECORD_H
 
+#include <memory>
 #include <string>
 
 #include "utl/log/loglevel.h"
+#include "utl/log/logsite.h"
+#include "utl/log/stacktrace.h"
 
 
 namespace utl {
@@ -14,6 +17,12 @@ struct LogRecord
 	std::string loggerName;
 	LogLevel level;
 	std::string message;
+	// pairs of the DiagnosticContext, like "request=42 tenant=acme"
+	std::string context;
+	// the call site, if the record was logged by a utl_log macro
+	const LogSite *site;
+	// the stack of the logging thread, see Logger::setStackTraceLevel()
+	std::shared_ptr<const StackTrace> stackTrace;
 	// infos about exception
 	// millis (time)
 	// thread id
@@ -23,7 +32,8 @@ struct LogRecord
 
 
 inline LogRecord::LogRecord() :
-	level(LogLevel::ALL)
+	level(LogLevel::ALL),
+	site(nullptr)
 {
 }
 
@@ -0,0 +1,56 @@
+#ifndef UTL_LOGSITE_H
+#define UTL_LOGSITE_H
+
+#include <cstddef>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Describes a place in the code where a record is logged.
+ *
+ * The `utl_log` macros create one constant descriptor per call site, so it
+ * costs nothing at runtime. A LogRecord only points to the descriptor, and
+ * its address can be used as id of the call site. The level is not part of
+ * the descriptor, so it can be any expression, see LogRecord::level.
+ */
+struct LogSite
+{
+	const char *file;
+	int line;
+	const char *function;
+	// the format string, if it is a string literal, otherwise nullptr
+	const char *format;
+
+	template<std::size_t N>
+	static constexpr const char *formatOf(const char (&format)[N]);
+	template<std::size_t N>
+	static constexpr const char *formatOf(char (&format)[N]);
+	template<typename T>
+	static constexpr const char *formatOf(const T &format);
+};
+
+
+template<std::size_t N>
+constexpr const char *LogSite::formatOf(const char (&format)[N])
+{
+	return format;
+}
+
+template<std::size_t N>
+constexpr const char *LogSite::formatOf(char (&)[N])
+{
+	return nullptr;
+}
+
+template<typename T>
+constexpr const char *LogSite::formatOf(const T &)
+{
+	return nullptr;
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_LOGSITE_H
@@ -0,0 +1,47 @@
+#ifndef UTL_LZ_H
+#define UTL_LZ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief A small and fast LZ77 codec for compressed log files.
+ *
+ * The format of a compressed block follows the LZ4 block format: a sequence
+ * of tokens, each followed by literals, a 16 bit offset and an optional
+ * extension of the match length. Every block is independent of the others.
+ */
+namespace lz {
+
+void compress(const char *src, std::size_t size, std::string &out);
+bool decompress(const char *src, std::size_t size, std::string &out);
+
+/**
+ * @brief Header in front of every block of a compressed log file.
+ *
+ * The header contains a magic number, whether the block is compressed, and
+ * the size of the block before and after compression. This makes it possible
+ * to skip blocks without decompressing them and to append to existing files.
+ */
+struct BlockHeader
+{
+	static const std::size_t SIZE = 12;
+
+	bool compressed;
+	std::uint32_t rawSize;
+	std::uint32_t storedSize;
+
+	void write(char *dest) const;
+	bool read(const char *src);
+};
+
+} // namespace lz
+} // namespace log
+} // namespace utl
+
+#endif // UTL_LZ_H
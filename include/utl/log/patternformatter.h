@@ -0,0 +1,131 @@
+#ifndef UTL_PATTERNFORMATTER_H
+#define UTL_PATTERNFORMATTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utl/log/logrecord.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Formats records according to a layout pattern.
+ *
+ * The pattern is compiled once into a list of steps. The following
+ * conversions are supported:
+ *
+ * | Conversion   | Output                                                |
+ * |--------------|-------------------------------------------------------|
+ * | `%l`         | The level                                             |
+ * | `%n`         | The name of the logger                                |
+ * | `%m`         | The message, continuation lines are indented          |
+ * | `%X`         | The diagnostic context like `[key=value]`, or nothing |
+ * | `%d`         | The current local time in ISO 8601 format             |
+ * | `%d{format}` | The current local time formatted with `strftime()`    |
+ * | `%t`         | An id of the current thread                           |
+ * | `%F`         | The file of the call site (`?` without site)          |
+ * | `%L`         | The line of the call site                             |
+ * | `%M`         | The function of the call site                         |
+ * | `%%`         | A percent sign                                        |
+ *
+ * The text between the dynamic conversions only depends on the logger and
+ * the level. It is rendered once per logger and level, including the color
+ * escape sequences, and taken from a cache afterwards. Every thread keeps the
+ * texts it used last, so formatting usually takes no lock. Behind that, the
+ * formatter keeps the texts of the #MAX_CACHED_LOGGERS most recently used
+ * loggers.
+ *
+ * If the record has a stack trace, it is appended with one indented line per
+ * frame. The frames are resolved to names at this point.
+ *
+ * Since LogRecord has no timestamp or thread, `%d` and `%t` refer to the
+ * formatting, which is the same as the logging for synchronous handlers.
+ */
+class PatternFormatter
+{
+public:
+	static const char *const DEFAULT_PATTERN;
+	static const std::size_t MAX_CACHED_LOGGERS = 256;
+	static const std::size_t MAX_THREAD_CACHED_PREFIXES = 8;
+
+	explicit PatternFormatter(const std::string &pattern = DEFAULT_PATTERN,
+			bool colors = false);
+
+	PatternFormatter(const PatternFormatter&) = delete;
+	PatternFormatter &operator=(const PatternFormatter&) = delete;
+
+	const std::string &getPattern() const;
+	bool hasColors() const;
+
+	void format(const LogRecord &record, std::string &out) const;
+	std::string format(const LogRecord &record) const;
+
+private:
+	enum class Op { PREFIX, MESSAGE, CONTEXT, DATE, THREAD, FILE, LINE, FUNCTION };
+	enum class Part { TEXT, LEVEL, NAME };
+
+	struct Step {
+		Op op;
+		// the index of the prefix in mRuns
+		std::size_t index;
+		// the format of the date
+		std::string argument;
+	};
+
+	typedef std::vector<std::pair<Part, std::string>> Run;
+	typedef std::vector<std::string> Prefixes;
+
+	// the prefixes of one logger by level
+	struct CacheEntry {
+		std::string loggerName;
+		std::vector<std::pair<int, std::shared_ptr<const Prefixes>>> levels;
+	};
+	typedef std::list<CacheEntry> CacheList;
+
+	const Prefixes &prefixes(const LogRecord &record) const;
+	std::shared_ptr<const Prefixes> lookup(const LogRecord &record) const;
+
+	const std::uint64_t mId;
+	const std::string mPattern;
+	const bool mColors;
+	std::vector<Step> mSteps;
+	std::vector<Run> mRuns;
+
+	// the loggers, the most recently used first
+	mutable CacheList mRecent;
+	mutable std::unordered_map<std::string, CacheList::iterator> mCache;
+	mutable std::mutex mMutex;
+
+};
+
+
+inline const std::string &PatternFormatter::getPattern() const
+{
+	return mPattern;
+}
+
+inline bool PatternFormatter::hasColors() const
+{
+	return mColors;
+}
+
+inline std::string PatternFormatter::format(const LogRecord &record) const
+{
+	std::string out;
+	format(record, out);
+	return out;
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_PATTERNFORMATTER_H
@@ -0,0 +1,148 @@
+#ifndef UTL_SCOPEDTIMER_H
+#define UTL_SCOPEDTIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utl/log/logger.h"
+#include "utl/log/loglevel.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Collects spans of ScopedTimer instances.
+ *
+ * The collected spans can be exported in the Chrome trace event format with
+ * writeJson(). The output can be opened with `chrome://tracing` or Perfetto.
+ */
+class TraceRecorder
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	TraceRecorder();
+	virtual ~TraceRecorder() = default;
+
+	void record(const char *name, Clock::time_point start, Clock::duration duration);
+	std::size_t size() const;
+	void clear();
+
+	void writeJson(std::ostream &stream) const;
+
+private:
+	struct Span {
+		const char *name;
+		long long start;
+		long long duration;
+		std::size_t thread;
+	};
+
+	const Clock::time_point mEpoch;
+	std::vector<Span> mSpans;
+	mutable std::mutex mMutex;
+};
+
+/**
+ * @brief Measures the time until the end of the scope.
+ *
+ * When the timer is destroyed, it logs the elapsed time with the given level
+ * and logger. Nothing is logged if the elapsed time is below the threshold.
+ * If the level is not enabled for the logger when the timer is created, the
+ * timer is disabled and does not even read the clock.
+ *
+ * ```
+ * void load()
+ * {
+ *     utl::log::ScopedTimer timer(logger, LogLevel::FINE, "load",
+ *             std::chrono::milliseconds(10));
+ *     // ...
+ * }
+ * ```
+ *
+ * The timer keeps the logger alive. The name is not copied, it should be a
+ * string literal.
+ */
+class ScopedTimer
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	ScopedTimer(const Logger &logger, const LogLevel &level, const char *name,
+			Clock::duration threshold = Clock::duration::zero(),
+			TraceRecorder *trace = nullptr);
+	~ScopedTimer();
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer &operator=(const ScopedTimer&) = delete;
+
+	bool isEnabled() const;
+	Clock::duration elapsed() const;
+	void stop();
+
+private:
+	std::shared_ptr<const Logger> mLogger;
+	LogLevel mLevel;
+	const char *mName;
+	Clock::duration mThreshold;
+	TraceRecorder *mTrace;
+	Clock::time_point mStart;
+};
+
+
+inline TraceRecorder::TraceRecorder() :
+	mEpoch(Clock::now())
+{
+}
+
+inline std::size_t TraceRecorder::size() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mSpans.size();
+}
+
+inline void TraceRecorder::clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSpans.clear();
+}
+
+inline ScopedTimer::ScopedTimer(const Logger &logger, const LogLevel &level,
+		const char *name, Clock::duration threshold, TraceRecorder *trace) :
+	mLogger(nullptr),
+	mLevel(level)
+{
+	if (!logger.isLoggable(level))
+		return;
+	mLogger = logger.share();
+	mName = name;
+	mThreshold = threshold;
+	mTrace = trace;
+	mStart = Clock::now();
+}
+
+inline ScopedTimer::~ScopedTimer()
+{
+	stop();
+}
+
+inline bool ScopedTimer::isEnabled() const
+{
+	return mLogger != nullptr;
+}
+
+inline ScopedTimer::Clock::duration ScopedTimer::elapsed() const
+{
+	return mLogger ? Clock::now() - mStart : Clock::duration::zero();
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_SCOPEDTIMER_H
@@ -0,0 +1,67 @@
+#ifndef UTL_SHAREDMEMORYLOGCOLLECTOR_H
+#define UTL_SHAREDMEMORYLOGCOLLECTOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utl/log/sharedmemoryring.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Drains the rings of all SharedMemoryLogHandler instances which use
+ * the same directory.
+ *
+ * Every call of collect() looks for new rings, reads all records and returns
+ * them ordered by time. Records of different processes which are written at
+ * almost the same time may become visible in different calls. Setting a
+ * delay holds back records younger than the delay, so they can be sorted
+ * together with records which arrive later.
+ *
+ * Rings of closed handlers and of processes which do not exist anymore are
+ * deleted once they are empty.
+ */
+class SharedMemoryLogCollector
+{
+public:
+	typedef SharedMemoryRing::Record Record;
+
+	explicit SharedMemoryLogCollector(const std::string &directory,
+			std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+	virtual ~SharedMemoryLogCollector() = default;
+
+	SharedMemoryLogCollector(const SharedMemoryLogCollector&) = delete;
+	SharedMemoryLogCollector &operator=(const SharedMemoryLogCollector&) = delete;
+
+	std::size_t collect(std::vector<Record> &records);
+	std::size_t collectAll(std::vector<Record> &records);
+
+	std::size_t getRingCount() const;
+
+private:
+	std::size_t collect(std::vector<Record> &records, bool all);
+	void scan();
+
+	const std::string mDirectory;
+	const std::chrono::milliseconds mDelay;
+	std::map<std::string, std::unique_ptr<SharedMemoryRing>> mRings;
+	std::vector<Record> mPending;
+
+};
+
+
+inline std::size_t SharedMemoryLogCollector::getRingCount() const
+{
+	return mRings.size();
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_SHAREDMEMORYLOGCOLLECTOR_H
@@ -0,0 +1,70 @@
+#ifndef UTL_SHAREDMEMORYLOGHANDLER_H
+#define UTL_SHAREDMEMORYLOGHANDLER_H
+
+#include <cstddef>
+#include <string>
+
+#include "utl/log/loghandler.h"
+#include "utl/log/logrecord.h"
+#include "utl/log/sharedmemoryring.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Writes records into a SharedMemoryRing, which is drained by a
+ * collector process.
+ *
+ * The handler creates a ring file named after the process in the given
+ * directory. Publishing a record only copies it into the ring, there are no
+ * system calls and no locks. The collector (`utl_logcollector` or a
+ * SharedMemoryLogCollector) reads the rings of all processes in the
+ * directory and writes the records ordered by time.
+ *
+ * ```
+ * Logger::getRoot().addHandler(
+ *         std::make_shared<SharedMemoryLogHandler>("/dev/shm/myapp"));
+ * ```
+ *
+ * If the process crashes, the records stay in the ring until the collector
+ * has read them. Records are dropped if the ring is full.
+ */
+class SharedMemoryLogHandler : public LogHandler
+{
+public:
+	explicit SharedMemoryLogHandler(const std::string &directory,
+			std::size_t capacity = 1024 * 1024);
+	virtual ~SharedMemoryLogHandler() noexcept;
+
+	bool good() const;
+	const std::string &getPath() const;
+	std::size_t getDroppedRecords() const;
+
+	virtual void publish(const LogRecord &record) override;
+
+private:
+	SharedMemoryRing mRing;
+
+};
+
+
+inline bool SharedMemoryLogHandler::good() const
+{
+	return mRing.good();
+}
+
+inline const std::string &SharedMemoryLogHandler::getPath() const
+{
+	return mRing.getPath();
+}
+
+inline std::size_t SharedMemoryLogHandler::getDroppedRecords() const
+{
+	return mRing.getDroppedRecords();
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_SHAREDMEMORYLOGHANDLER_H
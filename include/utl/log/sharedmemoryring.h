@@ -0,0 +1,107 @@
+#ifndef UTL_SHAREDMEMORYRING_H
+#define UTL_SHAREDMEMORYRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utl/log/logrecord.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief A ring buffer of records in a memory mapped file, shared between
+ * processes.
+ *
+ * Any number of threads of the producer process write records with write().
+ * Space is reserved with an atomic compare-and-swap, the record is copied
+ * and finally marked as committed, so writing needs neither locks nor system
+ * calls. If the ring is full, the record is dropped and counted.
+ *
+ * A collector process opens the same file and takes the committed records
+ * out with read(). Since the records live in the file, they survive a crash
+ * of the producer. A record which was reserved but never committed by a
+ * crashed producer is skipped.
+ *
+ * The file should be placed on a memory file system like `/dev/shm`, so it
+ * is never written to disk.
+ *
+ * @see SharedMemoryLogHandler
+ * @see SharedMemoryLogCollector
+ */
+class SharedMemoryRing
+{
+public:
+	static const std::uint32_t MAGIC = 0x524c5455;
+	static const std::uint32_t VERSION = 1;
+
+	/**
+	 * @brief A record taken out of the ring.
+	 */
+	struct Record {
+		// nanoseconds since the epoch of the system clock
+		std::int64_t time;
+		int pid;
+		LogRecord record;
+	};
+
+	SharedMemoryRing(const std::string &path, std::size_t capacity);
+	explicit SharedMemoryRing(const std::string &path);
+	virtual ~SharedMemoryRing() noexcept;
+
+	SharedMemoryRing(const SharedMemoryRing&) = delete;
+	SharedMemoryRing &operator=(const SharedMemoryRing&) = delete;
+
+	bool good() const;
+	const std::string &getPath() const;
+	std::size_t getCapacity() const;
+	int getPid() const;
+	std::size_t getDroppedRecords() const;
+
+	bool write(const LogRecord &record);
+	std::size_t read(std::vector<Record> &records);
+
+	void close();
+	bool isClosed() const;
+	bool isProducerAlive() const;
+	bool empty() const;
+
+private:
+	struct Header;
+
+	void copyIn(std::uint64_t pos, const void *src, std::size_t size);
+	void copyOut(std::uint64_t pos, void *dst, std::size_t size) const;
+	void clear(std::uint64_t pos, std::size_t size);
+
+	const std::string mPath;
+	void *mMemory;
+	std::size_t mSize;
+	Header *mHeader;
+	char *mData;
+	std::size_t mCapacity;
+
+};
+
+
+inline bool SharedMemoryRing::good() const
+{
+	return mHeader != nullptr;
+}
+
+inline const std::string &SharedMemoryRing::getPath() const
+{
+	return mPath;
+}
+
+inline std::size_t SharedMemoryRing::getCapacity() const
+{
+	return mCapacity;
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_SHAREDMEMORYRING_H
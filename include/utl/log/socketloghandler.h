@@ -0,0 +1,90 @@
+#ifndef UTL_SOCKETLOGHANDLER_H
+#define UTL_SOCKETLOGHANDLER_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "utl/log/loghandler.h"
+#include "utl/log/loglevel.h"
+#include "utl/log/logrecord.h"
+#include "utl/log/patternformatter.h"
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Forwards records to a local collector over a Unix domain socket.
+ *
+ * Records are formatted into lines and queued. The queue is sent in one
+ * system call (`sendmsg` with multiple buffers for stream sockets, `sendmmsg`
+ * for datagram sockets) once #getBatchSize() records are pending, when a
+ * record with at least the flush level arrives, or when flush() is called.
+ *
+ * The socket is non-blocking. If the collector is slow or not running, the
+ * records stay in the queue until the next attempt. The queue is bounded by
+ * setBufferLimit(); the oldest records are dropped when the limit is
+ * exceeded. If the connection breaks, the handler reconnects on the next
+ * attempt, so a restarted collector is picked up automatically. Records
+ * which are larger than a datagram socket accepts are dropped.
+ */
+class SocketLogHandler : public LogHandler
+{
+public:
+	enum class Type { STREAM, DATAGRAM };
+
+	explicit SocketLogHandler(const std::string &path, Type type = Type::STREAM,
+			const std::string &pattern = PatternFormatter::DEFAULT_PATTERN);
+	virtual ~SocketLogHandler() noexcept;
+
+	std::size_t getBatchSize() const;
+	void setBatchSize(std::size_t records);
+	std::size_t getBufferLimit() const;
+	void setBufferLimit(std::size_t bytes);
+	const LogLevel &getFlushLevel() const;
+	void setFlushLevel(const LogLevel &level);
+
+	bool isConnected() const;
+	std::size_t getPendingRecords() const;
+	std::size_t getDroppedRecords() const;
+
+	bool flush();
+
+	virtual void publish(const LogRecord &record) override;
+
+protected:
+	virtual void publishBatch(const LogRecord *records, std::size_t count) override;
+	virtual std::string format(const LogRecord &record) const;
+
+private:
+	bool connect();
+	void disconnect();
+	bool send();
+	bool sendStream();
+	bool sendDatagram();
+	void consume(std::size_t records);
+	void enqueue(std::string line);
+
+	const std::string mPath;
+	const Type mType;
+	const PatternFormatter mFormatter;
+	int mSocket;
+
+	std::size_t mBatchSize;
+	std::size_t mBufferLimit;
+	LogLevel mFlushLevel;
+
+	std::deque<std::string> mPending;
+	std::size_t mPendingBytes;
+	std::size_t mOffset;
+	std::size_t mDropped;
+	mutable std::mutex mMutex;
+
+};
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_SOCKETLOGHANDLER_H
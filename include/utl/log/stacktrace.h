@@ -0,0 +1,101 @@
+#ifndef UTL_STACKTRACE_H
+#define UTL_STACKTRACE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief The return addresses of the current thread, resolved to names only
+ * when the trace is written.
+ *
+ * Capturing only unwinds the stack into a fixed array, which takes a few
+ * microseconds and does not allocate memory. appendTo() looks up the module
+ * and the exported symbol of every address. It also writes the offset into
+ * the module, so a trace of a binary without exported symbols can be
+ * resolved later with its debug info:
+ *
+ * ```
+ * #2 0x55d0c2a4f3b1 in main+0x41 (/usr/bin/server+0x23b1)
+ * $ addr2line -f -C -e /usr/bin/server 0x23b1
+ * ```
+ *
+ * Loggers capture a trace for records at or above their stack trace level,
+ * see Logger::setStackTraceLevel(). Stack traces are only supported with
+ * glibc and on macOS; elsewhere, traces are empty.
+ */
+class StackTrace
+{
+public:
+	static const std::size_t MAX_DEPTH = 32;
+
+	StackTrace() noexcept;
+
+	void capture(std::size_t skip = 0, std::size_t depth = MAX_DEPTH) noexcept;
+	void assign(void *const *frames, std::size_t count) noexcept;
+
+	std::size_t size() const;
+	bool empty() const;
+	void *operator[](std::size_t index) const;
+	void *const *data() const;
+
+	void appendTo(std::string &str) const;
+	std::string toString() const;
+
+private:
+	void *mFrames[MAX_DEPTH];
+	std::size_t mSize;
+
+};
+
+
+inline StackTrace::StackTrace() noexcept :
+	mSize(0)
+{
+}
+
+inline std::size_t StackTrace::size() const
+{
+	return mSize;
+}
+
+inline bool StackTrace::empty() const
+{
+	return mSize == 0;
+}
+
+inline void *StackTrace::operator[](std::size_t index) const
+{
+	return mFrames[index];
+}
+
+/**
+ * @brief Replaces the frames by @p count addresses of an earlier capture,
+ * at most #MAX_DEPTH.
+ */
+inline void StackTrace::assign(void *const *frames, std::size_t count) noexcept
+{
+	mSize = std::min(count, MAX_DEPTH);
+	std::copy(frames, frames + mSize, mFrames);
+}
+
+inline void *const *StackTrace::data() const
+{
+	return mFrames;
+}
+
+inline std::string StackTrace::toString() const
+{
+	std::string str;
+	appendTo(str);
+	return str;
+}
+
+} // namespace log
+} // namespace utl
+
+#endif // UTL_STACKTRACE_H
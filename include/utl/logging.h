@@ -1,8 +1,11 @@
 #ifndef UTL_LOGGING_H
 #define UTL_LOGGING_H
 
+#include <memory>
+
 #include "utl/log/logger.h"
 #include "utl/log/loglevel.h"
+#include "utl/log/logsite.h"
 
 
 #ifndef UTL_LOGGER
@@ -11,7 +14,21 @@
 
 // TODO logger cache per file?
 
-#define utl_log(level, ...) utl::log::Logger::get(UTL_STR_VALUE(UTL_LOGGER)).log(level, __VA_ARGS__)
+/**
+ * Logs a message with the logger #UTL_LOGGER. Every call site gets a
+ * constant utl::log::LogSite with file, line, function and format, which is
+ * referenced by the record. The level is evaluated at every call.
+ */
+#define utl_log(level, ...) \
+	do { \
+		static constexpr utl::log::LogSite utl_log_site = {__FILE__, __LINE__, __func__, \
+				utl::log::LogSite::formatOf(UTL_LOG_FIRST(__VA_ARGS__))}; \
+		utl::log::Logger::getP(UTL_STR_VALUE(UTL_LOGGER))->log((level), utl_log_site, \
+				__VA_ARGS__); \
+	} while (false)
+#define UTL_LOG_FIRST(...) UTL_LOG_FIRST_(__VA_ARGS__, 0)
+#define UTL_LOG_FIRST_(first, ...) first
+
 #define utl_finest(...)  utl_log(utl::log::LogLevel::FINEST,  __VA_ARGS__)
 #define utl_finer(...)   utl_log(utl::log::LogLevel::FINER,   __VA_ARGS__)
 #define utl_fine(...)    utl_log(utl::log::LogLevel::FINE,    __VA_ARGS__)
@@ -23,8 +40,8 @@ namespace utl {
 
 template <typename... A>
 static inline void logl(log::LogLevel level , A... a) {
-	log::Logger &logger = log::Logger::get(UTL_STR_VALUE(UTL_LOGGER));
-	logger.log(level, a...);
+	std::shared_ptr<log::Logger> logger = log::Logger::getP(UTL_STR_VALUE(UTL_LOGGER));
+	logger->log(level, a...);
 }
 
 template <typename... A>
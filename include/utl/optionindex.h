@@ -0,0 +1,132 @@
+#ifndef UTL_OPTIONINDEX_H
+#define UTL_OPTIONINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace utl {
+
+/**
+ * @brief A radix trie over the names of registered options.
+ *
+ * This class is used by Arguments to look up options. Every node of the trie
+ * stores how many options in its subtree can be abbreviated to a prefix
+ * ending in this node. This way, exact matches, unique prefixes and ambiguous
+ * prefixes are resolved in a single walk over the name of the option.
+ *
+ * Names ending with `'='` take a parameter (see Arguments::registerOption()).
+ * Such an option is not a candidate for an abbreviation if the same option is
+ * also registered without `'='`, and options without `'='` are not
+ * candidates if the user gave a parameter.
+ */
+class OptionIndex
+{
+public:
+	/**
+	 * @brief A position within the trie.
+	 *
+	 * The position is @em depth characters behind the start of the edge which
+	 * leads to @em node.
+	 */
+	struct Cursor {
+		std::uint32_t node = 0;
+		std::size_t depth = 0;
+	};
+
+	OptionIndex();
+
+	void insert(const std::string &name, int key);
+	bool empty() const;
+
+	int find(const char *name, std::size_t len) const;
+
+	bool advance(Cursor &cursor, const char *str, std::size_t len) const;
+	int keyAt(const Cursor &cursor) const;
+	std::size_t countCandidates(const Cursor &cursor, bool hasParam) const;
+	Cursor firstCandidate(const Cursor &cursor, bool hasParam) const;
+	const std::string &nameAt(const Cursor &cursor) const;
+
+	template<typename F>
+	void forEachCandidate(const Cursor &cursor, bool hasParam, F func) const;
+
+private:
+	struct Node {
+		std::string label;
+		std::string name;
+		int key = 0;
+		std::vector<std::uint32_t> children;
+		// Amount of candidates without and with '=' in the subtree
+		std::size_t plain = 0;
+		std::size_t paramOnly = 0;
+	};
+
+	std::uint32_t child(std::uint32_t node, char c) const;
+	std::size_t count(std::uint32_t node, bool hasParam) const;
+	bool isCandidate(const Node &node, bool hasParam) const;
+	void adjust(const std::string &name, int plain, int paramOnly);
+
+	template<typename F>
+	void visit(std::uint32_t node, bool hasParam, F &func) const;
+
+	std::vector<Node> nodes;
+	std::size_t options = 0;
+};
+
+
+inline bool OptionIndex::empty() const
+{
+	return options == 0;
+}
+
+inline int OptionIndex::keyAt(const Cursor &cursor) const
+{
+	const Node &node = nodes[cursor.node];
+	return (cursor.depth == node.label.size()) ? node.key : 0;
+}
+
+inline std::size_t OptionIndex::countCandidates(const Cursor &cursor, bool hasParam) const
+{
+	return count(cursor.node, hasParam);
+}
+
+inline const std::string &OptionIndex::nameAt(const Cursor &cursor) const
+{
+	return nodes[cursor.node].name;
+}
+
+inline std::size_t OptionIndex::count(std::uint32_t node, bool hasParam) const
+{
+	return (hasParam ? 0 : nodes[node].plain) + nodes[node].paramOnly;
+}
+
+/**
+ * @brief Calls @p func with the name and key of every candidate below the
+ * cursor.
+ *
+ * The candidates are visited in lexicographical order. Subtrees without
+ * candidates are skipped.
+ */
+template<typename F>
+inline void OptionIndex::forEachCandidate(const Cursor &cursor, bool hasParam, F func) const
+{
+	visit(cursor.node, hasParam, func);
+}
+
+template<typename F>
+inline void OptionIndex::visit(std::uint32_t idx, bool hasParam, F &func) const
+{
+	const Node &node = nodes[idx];
+	if (node.key != 0 && isCandidate(node, hasParam))
+		func(node.name, node.key);
+	for (std::uint32_t c : node.children) {
+		if (count(c, hasParam) > 0)
+			visit(c, hasParam, func);
+	}
+}
+
+} // namespace utl
+
+#endif // UTL_OPTIONINDEX_H
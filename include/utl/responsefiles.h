@@ -0,0 +1,93 @@
+#ifndef UTL_RESPONSEFILES_H
+#define UTL_RESPONSEFILES_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace utl {
+
+/**
+ * @brief Expands response files (`@file`) in an argument list.
+ *
+ * Every argument of the form `@file` is replaced by the arguments stored in
+ * the file, like GCC and other GNU tools do. This allows argument lists
+ * which are longer than the operating system permits (see `ARG_MAX`).
+ * Arguments starting with `@` which do not name a readable file are kept
+ * unchanged. The first argument (the name of the program) is never expanded.
+ *
+ * ```
+ * int main(int argc, const char *argv[])
+ * {
+ *     utl::ResponseFiles files(argc, argv);
+ *     utl::Arguments args(files.argc(), files.argv());
+ *     // ...
+ * }
+ * ```
+ *
+ * Within a file, arguments are separated by whitespace. They can be quoted
+ * with `'` or `"`, and outside of single quotes, a backslash takes the next
+ * character literally. A `#` at the start of an argument begins a comment
+ * which runs to the end of the line. Arguments in a file which start with
+ * `@` are expanded as well. A file including itself (directly or
+ * indirectly) results in an exception.
+ *
+ * The files are memory mapped and the arguments are unquoted in place, so
+ * the arguments point into the mapping instead of being copied. The
+ * pointers returned by argv() are valid as long as the ResponseFiles object
+ * exists.
+ */
+class ResponseFiles
+{
+public:
+	ResponseFiles(int argc, char const * const argv[]);
+	~ResponseFiles();
+
+	ResponseFiles(const ResponseFiles&) = delete;
+	ResponseFiles &operator=(const ResponseFiles&) = delete;
+
+	int argc() const;
+	char const * const *argv() const;
+
+private:
+	struct Mapping {
+		char *data;
+		std::size_t size;
+	};
+
+	void expand(const char *path, const char *arg);
+	void tokenize(char *first, char *last, const char *path);
+	void release();
+
+	std::vector<const char*> args;
+	std::vector<Mapping> mappings;
+	// Files which are currently expanded (for cycle detection)
+	std::vector<std::string> expanding;
+	// Storage for arguments which could not be terminated within the file
+	std::deque<std::string> copies;
+};
+
+
+/**
+ * @brief Returns the amount of arguments after the expansion.
+ */
+inline int ResponseFiles::argc() const
+{
+	return static_cast<int>(args.size()) - 1;
+}
+
+/**
+ * @brief Returns the arguments after the expansion.
+ *
+ * Like the `argv` of `main()`, the list is terminated by a null pointer.
+ */
+inline char const * const *ResponseFiles::argv() const
+{
+	return args.data();
+}
+
+} // namespace utl
+
+#endif // UTL_RESPONSEFILES_H
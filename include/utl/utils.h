@@ -37,14 +37,15 @@ std::string format(const std::string format, A... args);
 template <typename... A>
 inline std::string format(const std::string format, A... args)
 {
-	std::size_t final_n = 2 * format.size(), n = 0;
+	long long final_n = 2 * static_cast<long long>(format.size());
+	std::size_t n = 0;
 	std::unique_ptr<char[]> formatted;
 	do {
-		n += std::llabs(final_n - n + 1);
+		n += static_cast<std::size_t>(std::llabs(final_n - static_cast<long long>(n) + 1));
 		formatted.reset(new char[n]);
 		final_n = std::snprintf(formatted.get(), n, format.c_str(), args...);
 		// TODO catch negative final_n and throw exception?
-	} while (final_n < 0 || final_n >= n);
+	} while (final_n < 0 || static_cast<std::size_t>(final_n) >= n);
 	return std::string(formatted.get());
 }
 
@@ -1,12 +1,15 @@
 #include "utl/arguments.h"
 
-#include <climits>
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 using std::string;
 
 static bool isOption(const char *arg);
-static string strPlus1(const string& str);
+static int compareName(const char *name, const char *str, std::size_t len);
+static const utl::OptionDef *findWithParam(const utl::OptionTable &table,
+		const char *name, std::size_t len);
 
 
 namespace utl {
@@ -56,10 +59,11 @@ int Arguments::getNextOption()
 				break;
 			} else {
 				// Argument found, save it for later
-				params.push(argv[idxArg++]);
+				params.push_back(idxArg++);
 			}
 		}
 
+		idxOption = idxArg;
 		if (argv[idxArg][1] != '-') {
 			// The argument is a set of short options (-xyz)
 			// We will handle it below
@@ -76,77 +80,256 @@ int Arguments::getNextOption()
 			// Get name of the option // TODO and set '=' to '\0' if necessary
 			while (opt[idxChar] != '=' && opt[idxChar] != '\0')
 				++idxChar;
+			optionName = opt;
+			optionLength = idxChar;
 			if (opt[idxChar] == '=') {
-				currentOption.assign(opt, idxChar);
 				idxChar++;
 				hasParam = true;
 				//opt[idxChar++] = '\0'; // TODO
 			} else {
-				currentOption = opt;
 				idxArg++; idxChar = 0;
 			}
-			// Check whether there is an option with this name
-			if (!hasParam) {
-				auto it = optionMap.find(currentOption);
-				if (it != optionMap.end()) {
-					return it->second;
-				}
-			}
-			{
-				auto it = optionMap.find(currentOption + "=");
-				if (it != optionMap.end()) {
-					currentOption.push_back('=');
-					return it->second;
-				}
-			}
-			// Fill possibleOptions
-			possibleOptions.clear();
-			auto it = optionMap.lower_bound(currentOption);
-			auto end = optionMap.lower_bound(strPlus1(currentOption));
-			for (; it != end; ++it) {
-				const string &name = it->first;
-				if (!hasParam && name.back() != '=') {
-					possibleOptions.insert(*it);
-				} else if (name.back() == '=') {
-					string base = name.substr(0, name.size() - 1);
-					if (optionMap.find(base) == optionMap.end())
-						possibleOptions.insert(*it);
-				}
-			}
-			// Check possible options
-			switch (possibleOptions.size()) {
-			case 0: // No matching option found
-				if (hasParam)
-					currentOption += '=';
-				return -1;
-				break;
-			case 1: // There is only one option, return it
-				it = possibleOptions.begin();
-				currentOption = it->first;
-				return it->second;
-				break;
-			default: // Multiple possibilities
-				if (hasParam)
-					currentOption += '=';
-				return -2;
-				break;
-			}
+			if (optionTable.size() > 0)
+				return findLongOptionInTable(hasParam);
+			else
+				return findLongOption(hasParam);
 		}
 	}
 
 	// We are in a set of short options (-xyz)
 	// Get the next option
-	currentOption = {'-', argv[idxArg][idxChar++]};
+	idxOption = idxArg;
+	optionName = nullptr;
+	optionLength = 2;
+	shortOption[1] = argv[idxArg][idxChar++];
 	if (argv[idxArg][idxChar] == '\0') {
 		++idxArg; idxChar = 0;
 	}
 	// and return it
-	auto it = optionMap.find(currentOption);
-	if (it == optionMap.end()) {
-		return strictRefuse ? -1 : currentOption[1];
+	return findShortOption();
+}
+
+/**
+ * @brief Returns the next option without signaling errors by the return
+ * value.
+ *
+ * Works like getNextOption(), but unknown and ambiguous options are reported
+ * in @p error, including their position in `argv` and the possible options.
+ * No exception is thrown and nothing is allocated unless there is an error.
+ * The function can be called again after an error to continue with the next
+ * option.
+ *
+ * ```
+ * utl::ArgumentError error;
+ * while (int opt = args.tryGetNextOption(error)) {
+ *     // ...
+ * }
+ * if (error) {
+ *     cerr << error.message() << endl;
+ *     return EXIT_FAILURE;
+ * }
+ * ```
+ *
+ * @return The @em key of the option, or `0` if there is no option available
+ *         anymore or if the option could not be determined.
+ *
+ * @see getNextOption()
+ */
+int Arguments::tryGetNextOption(ArgumentError &error)
+{
+	error.clear();
+	int key = getNextOption();
+	if (key >= 0)
+		return key;
+
+	error.kind = (key == -2) ? ArgumentError::AMBIGUOUS_OPTION : ArgumentError::UNKNOWN_OPTION;
+	error.position = idxOption;
+	error.token.assign(currentOption(), optionLength);
+	if (key == -2) {
+		for (const std::pair<const std::string, int> &option : getPossibleOptions())
+			error.candidates.push_back(option.first);
+	}
+	return 0;
+}
+
+/**
+ * @brief Looks up the long option in optionName within optionIndex.
+ *
+ * The lookup walks the trie along the name once. If the option is ambiguous,
+ * only the position within the trie is stored. getPossibleOptions() collects
+ * the candidates when it is called.
+ *
+ * @see getNextOption()
+ */
+int Arguments::findLongOption(bool hasParam)
+{
+	const OptionIndex &optionIndex = options();
+	OptionIndex::Cursor cursor;
+	std::size_t candidates = 0;
+	if (optionIndex.advance(cursor, optionName, optionLength)) {
+		// Check whether there is an option with this name
+		if (!hasParam) {
+			if (int key = optionIndex.keyAt(cursor))
+				return key;
+		}
+		OptionIndex::Cursor withParam = cursor;
+		if (optionIndex.advance(withParam, "=", 1)) {
+			if (int key = optionIndex.keyAt(withParam)) {
+				setOptionName(optionIndex.nameAt(withParam).c_str());
+				return key;
+			}
+		}
+		candidates = optionIndex.countCandidates(cursor, hasParam);
+	}
+
+	// Check possible options
+	switch (candidates) {
+	case 0: // No matching option found
+		if (hasParam)
+			++optionLength;
+		return -1;
+	case 1: // There is only one option, return it
+		cursor = optionIndex.firstCandidate(cursor, hasParam);
+		setOptionName(optionIndex.nameAt(cursor).c_str());
+		return optionIndex.keyAt(cursor);
+	default: // Multiple possibilities
+		ambiguousPrefix = cursor;
+		ambiguousParam = hasParam;
+		possibleOptionsValid = false;
+		if (hasParam)
+			++optionLength;
+		return -2;
+	}
+}
+
+/**
+ * @brief Looks up the long option in optionName within optionTable.
+ *
+ * Works like findLongOption(), but the candidates are found with a binary
+ * search over the sorted table. possibleOptions is only filled if the option
+ * is ambiguous.
+ *
+ * @see getNextOption()
+ */
+int Arguments::findLongOptionInTable(bool hasParam)
+{
+	// Check whether there is an option with this name
+	if (!hasParam) {
+		const OptionDef *def = optionTable.find(optionName, optionLength);
+		if (def)
+			return def->key;
+	}
+	if (const OptionDef *def = findWithParam(optionTable, optionName, optionLength)) {
+		setOptionName(def->name);
+		return def->key;
+	}
+
+	// Search possible options
+	auto isCandidate = [this, hasParam](const OptionDef &def) {
+		std::size_t len = std::strlen(def.name);
+		if (def.name[len - 1] != '=')
+			return !hasParam;
+		return optionTable.find(def.name, len - 1) == nullptr;
+	};
+	const OptionDef *begin = optionTable.lowerBound(optionName, optionLength);
+	const OptionDef *end = optionTable.prefixEnd(optionName, optionLength);
+	const OptionDef *match = nullptr;
+	std::size_t matches = 0;
+	for (const OptionDef *def = begin; def != end; ++def) {
+		if (isCandidate(*def)) {
+			match = def;
+			++matches;
+		}
+	}
+
+	// Check possible options
+	switch (matches) {
+	case 0: // No matching option found
+		if (hasParam)
+			++optionLength;
+		return -1;
+	case 1: // There is only one option, return it
+		setOptionName(match->name);
+		return match->key;
+	default: // Multiple possibilities
+		possibleOptions.clear();
+		possibleOptionsValid = true;
+		for (const OptionDef *def = begin; def != end; ++def) {
+			if (isCandidate(*def))
+				possibleOptions.emplace(def->name, def->key);
+		}
+		if (hasParam)
+			++optionLength;
+		return -2;
+	}
+}
+
+/**
+ * @brief Looks up the short option in shortOption.
+ * @see getNextOption()
+ */
+int Arguments::findShortOption()
+{
+	if (optionTable.size() > 0) {
+		const OptionDef *def = optionTable.find(shortOption, 2);
+		if (def)
+			return def->key;
 	} else {
-		return it->second;
+		if (int key = options().find(shortOption, 2))
+			return key;
+	}
+	return strictRefuse ? -1 : static_cast<unsigned char>(shortOption[1]);
+}
+
+/**
+ * @brief Finds the option with exactly the given name.
+ * @return The entry, or `nullptr` if there is no such option.
+ */
+const OptionDef *OptionTable::find(const char *name, std::size_t len) const
+{
+	const OptionDef *it = lowerBound(name, len);
+	if (it != end() && compareName(it->name, name, len) == 0)
+		return it;
+	return nullptr;
+}
+
+/**
+ * @brief Returns the first entry which is not less than the given string.
+ */
+const OptionDef *OptionTable::lowerBound(const char *prefix, std::size_t len) const
+{
+	const OptionDef *first = begin();
+	std::size_t count = size();
+	while (count > 0) {
+		std::size_t step = count / 2;
+		if (compareName(first[step].name, prefix, len) < 0) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+	return first;
+}
+
+/**
+ * @brief Returns the first entry behind all entries which start with the
+ * given prefix.
+ */
+const OptionDef *OptionTable::prefixEnd(const char *prefix, std::size_t len) const
+{
+	const OptionDef *first = lowerBound(prefix, len);
+	std::size_t count = end() - first;
+	while (count > 0) {
+		std::size_t step = count / 2;
+		if (std::strncmp(first[step].name, prefix, len) == 0) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
 	}
+	return first;
 }
 
 /**
@@ -168,32 +351,135 @@ int Arguments::getNextOption()
  */
 bool Arguments::getNextArgument(std::string& param)
 {
-	if (noOptions && !params.empty()) {
-		param = params.front();
-		params.pop();
-		return true;
+	const char *arg = nextArgument();
+	if (arg == nullptr)
+		return false;
+	param = arg;
+	return true;
+}
+
+/**
+ * @brief Starts to parse another argument list.
+ *
+ * The registered options are kept, but everything else is set back to the
+ * state after the construction. Memory which was allocated for the previous
+ * argument list is reused. This way, one instance can be used as context to
+ * parse many argument lists, one after another.
+ *
+ * @param argc The amount of arguments.
+ * @param argv An array of all arguments. This array should contain @em `argc`
+ *             c-strings.
+ */
+void Arguments::reset(int argc, const char * const argv[])
+{
+	this->argc = argc;
+	this->argv = argv;
+	idxArg = 1;
+	idxChar = 0;
+	idxOption = 0;
+	idxArgument = 0;
+	params.clear();
+	params.reserve(argc);
+	idxParam = 0;
+	noOptions = false;
+	optionName = nullptr;
+	optionLength = 0;
+	ambiguousParam = false;
+	possibleOptionsValid = true;
+	possibleOptions.clear();
+}
+
+/**
+ * @brief Advances to the next argument and returns it.
+ *
+ * Arguments skipped by getNextOption() are only stored as index into `argv`,
+ * so no argument is copied before the caller asks for it.
+ *
+ * @return The next argument, or `nullptr` if there is no argument left.
+ */
+const char *Arguments::nextArgument()
+{
+	if (noOptions && idxParam < params.size()) {
+		idxArgument = params[idxParam];
+		return argv[params[idxParam++]];
 	}
 
 	if (idxArg < argc) {
-		param = &argv[idxArg][idxChar];
+		idxArgument = idxArg;
+		const char *arg = &argv[idxArg][idxChar];
 		idxArg++; idxChar = 0;
-		return true;
+		return arg;
 	} else {
-		return false;
+		return nullptr;
+	}
+}
+
+/**
+ * @brief Sets the error back to ArgumentError::NONE.
+ */
+void ArgumentError::clear()
+{
+	kind = NONE;
+	position = 0;
+	token.clear();
+	candidates.clear();
+}
+
+/**
+ * @brief Returns a message which describes the error.
+ */
+std::string ArgumentError::message() const
+{
+	switch (kind) {
+	case NONE:
+		return "No error";
+	case UNKNOWN_OPTION:
+		return "Unknown option " + token;
+	case AMBIGUOUS_OPTION: {
+		string msg = "Ambiguous option " + token + " (possible options:";
+		for (const string &candidate : candidates)
+			msg += " " + candidate;
+		return msg + ")";
+	}
+	case MISSING_ARGUMENT:
+		return "Missing argument";
+	case INVALID_ARGUMENT:
+		return "Invalid argument " + token;
 	}
+	return "Unknown error";
 }
 
 } // namespace utl
 
 
-string strPlus1(const string& str)
+/**
+ * Compares a null terminated name with a string of the given length, just
+ * like `strcmp` would do.
+ */
+int compareName(const char *name, const char *str, std::size_t len)
 {
-	string tmp = str;
-	for (int i = tmp.size() - 1; i >= 0; --i) {
-		if (tmp[i] < CHAR_MAX) {
-			++tmp[i];
-			break;
-		}
+	for (std::size_t i = 0; i < len; ++i) {
+		unsigned char a = name[i], b = str[i];
+		if (a != b)
+			return (a == '\0' || a < b) ? -1 : 1;
 	}
-	return tmp;
+	return name[len] == '\0' ? 0 : 1;
+}
+
+/**
+ * Finds the entry of the table with the given name followed by `'='`. The
+ * entries which start with the name are sorted by the following character, so
+ * the entry is the first one which continues with `'='`.
+ */
+const utl::OptionDef *findWithParam(const utl::OptionTable &table,
+		const char *name, std::size_t len)
+{
+	const utl::OptionDef *end = table.prefixEnd(name, len);
+	const utl::OptionDef *it = std::partition_point(table.lowerBound(name, len), end,
+			[len](const utl::OptionDef &def) {
+				return static_cast<unsigned char>(def.name[len]) < '=';
+			});
+	if (it != end && it->name[len] == '=' && it->name[len + 1] == '\0')
+		return it;
+	return nullptr;
 }
@@ -0,0 +1,89 @@
+#include "utl/argumentschema.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+
+namespace utl {
+
+/**
+ * @brief Parses the arguments and writes the options to their variables.
+ *
+ * @return All arguments which are not options or parameters of options.
+ * @throws ArgumentException If an option is unknown or ambiguous, or if the
+ *         parameter of an option is missing or invalid.
+ */
+std::vector<std::string> ArgumentSchema::parse(int argc, const char * const argv[])
+{
+	return parse(argc, argv, nullptr);
+}
+
+/**
+ * @brief Parses the arguments and takes missing long options from
+ * @p fallback.
+ *
+ * After the command line has been parsed, every long option whose variable
+ * was not written yet is looked up in @p fallback. If multiple long options
+ * are bound to the same variable, the first one found is used. Flags are
+ * read with argr::boolean. A value which is rejected by its reader causes a
+ * `std::runtime_error`, since it has no position within `argv`.
+ *
+ * @see parse(int, const char *const[])
+ */
+std::vector<std::string> ArgumentSchema::parse(int argc, const char * const argv[],
+		ConfigSource &fallback)
+{
+	return parse(argc, argv, &fallback);
+}
+
+std::vector<std::string> ArgumentSchema::parse(int argc, const char * const argv[],
+		ConfigSource *fallback)
+{
+	std::unordered_set<const void*> given;
+	Arguments args(argc, argv, OptionTable(table.data(), table.size()), true);
+
+	ArgumentError error;
+	while (int key = args.tryGetNextOption(error)) {
+		bindings[key - 1]->read(args);
+		if (fallback)
+			given.insert(bindings[key - 1]->target());
+	}
+	if (error)
+		throw ArgumentException(error);
+
+	if (fallback) {
+		std::string value;
+		for (const std::unique_ptr<Binding> &binding : bindings) {
+			if (binding->name.compare(0, 2, "--") != 0 || given.count(binding->target()))
+				continue;
+			if (fallback->lookup(ConfigSource::keyOf(binding->name), value)) {
+				binding->read(value);
+				given.insert(binding->target());
+			}
+		}
+	}
+
+	std::vector<std::string> rest;
+	rest.reserve(args.getArgumentsLeft());
+	std::string arg;
+	while (args.getNextArgument(arg))
+		rest.push_back(arg);
+	return rest;
+}
+
+void ArgumentSchema::add(Binding *binding)
+{
+	std::unique_ptr<Binding> owner(binding);
+	OptionDef def = {binding->name.c_str(), static_cast<int>(bindings.size() + 1)};
+	auto pos = std::lower_bound(table.begin(), table.end(), def,
+			[](const OptionDef &a, const OptionDef &b) {
+				return std::strcmp(a.name, b.name) < 0;
+			});
+	if (pos != table.end() && std::strcmp(pos->name, def.name) == 0)
+		throw std::invalid_argument("Option " + binding->name + " is bound already");
+	table.insert(pos, def);
+	bindings.push_back(std::move(owner));
+}
+
+} // namespace utl
@@ -0,0 +1,188 @@
+#include "utl/arguments.h"
+
+#include <cstring>
+#include <ostream>
+#include <string>
+
+using std::string;
+
+static string functionName(const string &program);
+static string quoteSingle(const string &str);
+static string quoteDouble(const string &str);
+static string zshSpec(const string &option);
+
+
+namespace utl {
+
+/**
+ * @brief Returns all registered options which start with @p prefix.
+ *
+ * The candidates are found in the same way as for getPossibleOptions(), so
+ * an option registered with and without `'='` is only returned once. The
+ * result is sorted by name.
+ *
+ * @param prefix The word which should be completed, like `--deb`.
+ * @return The names of the options, like `--debug`.
+ */
+std::vector<string> Arguments::complete(const string &prefix) const
+{
+	std::vector<string> result;
+	if (prefix.find('=') != string::npos)
+		return result;
+
+	if (optionTable.size() > 0) {
+		const OptionDef *end = optionTable.prefixEnd(prefix.data(), prefix.size());
+		for (const OptionDef *def = optionTable.lowerBound(prefix.data(), prefix.size());
+				def != end; ++def) {
+			std::size_t len = std::strlen(def->name);
+			if (len > 0 && def->name[len - 1] == '=' && optionTable.find(def->name, len - 1))
+				continue;
+			result.push_back(def->name);
+		}
+	} else {
+		const OptionIndex &optionIndex = options();
+		OptionIndex::Cursor cursor;
+		if (optionIndex.advance(cursor, prefix.data(), prefix.size())) {
+			optionIndex.forEachCandidate(cursor, false, [&result](const string &name, int) {
+				result.push_back(name);
+			});
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Answers a completion query if the program was called for one.
+ *
+ * If the first argument equals @p trigger, the options which start with the
+ * second argument are written to @p out (one per line). The function should
+ * be called right after the options are registered, so the program can
+ * exit before anything else is initialized:
+ *
+ * ```
+ * Arguments args(argc, argv);
+ * args.registerOption("--debug", OPT_DEBUG);
+ * if (args.handleCompletion(std::cout))
+ *     return EXIT_SUCCESS;
+ * ```
+ *
+ * `myapp --complete --de` would print `--debug` in this example.
+ *
+ * @return `true` if a completion query was answered, `false` otherwise.
+ */
+bool Arguments::handleCompletion(std::ostream &out, const char *trigger) const
+{
+	if (argc < 2 || std::strcmp(argv[1], trigger) != 0)
+		return false;
+
+	for (const string &option : complete(argc > 2 ? argv[2] : ""))
+		out << option << '\n';
+	return true;
+}
+
+/**
+ * @brief Writes a static completion script for the registered options.
+ *
+ * The script completes options for words starting with `-` and file names
+ * otherwise. It does not call the program, so completion does not even cost
+ * a process start.
+ *
+ * ```
+ * myapp --completion-script > /etc/bash_completion.d/myapp
+ * ```
+ *
+ * @param out The stream the script is written to.
+ * @param shell The shell which should load the script.
+ * @param program The name of the program as typed by the user.
+ */
+void Arguments::writeCompletionScript(std::ostream &out, CompletionShell shell,
+		const string &program) const
+{
+	std::vector<string> all = complete("");
+	switch (shell) {
+	case BASH: {
+		string name = functionName(program);
+		string words;
+		for (const string &option : all)
+			words += (words.empty() ? "" : " ") + option;
+		out << "# bash completion for " << program << "\n"
+		    << name << "()\n"
+		    << "{\n"
+		    << "    local cur=\"${COMP_WORDS[COMP_CWORD]}\"\n"
+		    << "    if [[ \"$cur\" == -* ]]; then\n"
+		    << "        COMPREPLY=($(compgen -W \"" << quoteDouble(words) << "\" -- \"$cur\"))\n"
+		    << "        if [[ ${#COMPREPLY[@]} -eq 1 && \"${COMPREPLY[0]}\" == *= ]]; then\n"
+		    << "            compopt -o nospace\n"
+		    << "        fi\n"
+		    << "    else\n"
+		    << "        COMPREPLY=($(compgen -f -- \"$cur\"))\n"
+		    << "    fi\n"
+		    << "}\n"
+		    << "complete -o filenames -F " << name << " " << quoteSingle(program) << "\n";
+		break;
+	}
+	case ZSH:
+		out << "#compdef " << program << "\n"
+		    << "_arguments -s";
+		for (const string &option : all)
+			out << " \\\n    " << quoteSingle(zshSpec(option));
+		out << " \\\n    '*:file:_files'\n";
+		break;
+	}
+}
+
+} // namespace utl
+
+
+/**
+ * Returns the name of the bash function for the program.
+ */
+string functionName(const string &program)
+{
+	string name = "_";
+	for (char c : program.substr(program.find_last_of('/') + 1)) {
+		bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+				(c >= '0' && c <= '9') || c == '_';
+		name += valid ? c : '_';
+	}
+	return name;
+}
+
+string quoteSingle(const string &str)
+{
+	string result = "'";
+	for (char c : str) {
+		if (c == '\'')
+			result += "'\\''";
+		else
+			result += c;
+	}
+	return result + "'";
+}
+
+string quoteDouble(const string &str)
+{
+	string result;
+	for (char c : str) {
+		if (c == '"' || c == '$' || c == '`' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+	return result;
+}
+
+/**
+ * Returns the specification of an option for `_arguments`.
+ */
+string zshSpec(const string &option)
+{
+	string spec;
+	for (char c : option) {
+		if (c == ':' || c == '[' || c == ']' || c == '\\')
+			spec += '\\';
+		spec += c;
+	}
+	if (!option.empty() && option.back() == '=')
+		spec += ":value: ";
+	return spec;
+}
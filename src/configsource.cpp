@@ -0,0 +1,195 @@
+#include "utl/configsource.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(unix) || defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTL_CONFIGSOURCE_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+static bool isBlank(char c);
+
+
+namespace utl {
+
+ConfigSource::~ConfigSource()
+{
+	close();
+}
+
+/**
+ * @brief Sets the config file.
+ *
+ * The file is not opened until a value is looked up in it.
+ */
+void ConfigSource::setFile(const std::string &path)
+{
+	close();
+	this->path = path;
+}
+
+/**
+ * @brief Looks up the value for the given key.
+ *
+ * @param key The key as returned by keyOf().
+ * @param value The function will write the value to this parameter.
+ * @return `false` if neither the environment nor the file contain the key.
+ */
+bool ConfigSource::lookup(const std::string &key, std::string &value)
+{
+	if (hasEnvPrefix) {
+		std::string name = envPrefix;
+		for (char c : key)
+			name += (c == '-') ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		if (const char *env = std::getenv(name.c_str())) {
+			value = env;
+			return true;
+		}
+	}
+	return !path.empty() && lookupFile(key, value);
+}
+
+/**
+ * @brief Returns the key of an option.
+ *
+ * The leading dashes and a trailing `'='` are removed, so `--log-level=`
+ * becomes `log-level`.
+ */
+std::string ConfigSource::keyOf(const std::string &optionName)
+{
+	std::size_t first = optionName.find_first_not_of('-');
+	if (first == std::string::npos)
+		return std::string();
+	std::size_t last = optionName.size();
+	if (optionName[last - 1] == '=')
+		--last;
+	return optionName.substr(first, last - first);
+}
+
+bool ConfigSource::lookupFile(const std::string &key, std::string &value)
+{
+	if (!opened) {
+		open();
+		buildIndex();
+	}
+
+	auto it = index.find(Key{key.data(), key.size()});
+	if (it == index.end())
+		return false;
+	value.assign(data + it->second.first, data + it->second.second);
+	return true;
+}
+
+bool ConfigSource::Key::operator==(const Key &other) const
+{
+	return size == other.size && std::memcmp(data, other.data, size) == 0;
+}
+
+/**
+ * FNV-1a, since std::hash only accepts strings before C++17.
+ */
+std::size_t ConfigSource::KeyHash::operator()(const Key &key) const
+{
+	std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+	for (std::size_t i = 0; i < key.size; ++i) {
+		hash ^= static_cast<unsigned char>(key.data[i]);
+		hash *= static_cast<std::size_t>(1099511628211ULL);
+	}
+	return hash;
+}
+
+void ConfigSource::open()
+{
+	opened = true;
+#ifdef UTL_CONFIGSOURCE_MMAP
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat info;
+	if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		void *map = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ,
+				MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			data = static_cast<const char*>(map);
+			size = static_cast<std::size_t>(info.st_size);
+		}
+	}
+	::close(fd);
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return;
+	std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	char *copy = new char[content.size()];
+	content.copy(copy, content.size());
+	data = copy;
+	size = content.size();
+#endif
+}
+
+/**
+ * Adds the value ranges of all keys of the file to the index. Only the first
+ * occurrence of a key is kept.
+ */
+void ConfigSource::buildIndex()
+{
+	std::size_t next = 0;
+	while (next < size) {
+		std::size_t pos = next;
+		std::size_t end = pos;
+		while (end < size && data[end] != '\n')
+			++end;
+		next = (end < size) ? end + 1 : end;
+
+		while (pos < end && isBlank(data[pos]))
+			++pos;
+		if (pos == end || data[pos] == '#')
+			continue;
+		std::size_t keyEnd = pos;
+		while (keyEnd < end && data[keyEnd] != '=')
+			++keyEnd;
+		if (keyEnd == end)
+			continue;
+		std::size_t valueStart = keyEnd + 1;
+		while (keyEnd > pos && isBlank(data[keyEnd - 1]))
+			--keyEnd;
+		while (valueStart < end && isBlank(data[valueStart]))
+			++valueStart;
+		std::size_t valueEnd = end;
+		while (valueEnd > valueStart && isBlank(data[valueEnd - 1]))
+			--valueEnd;
+
+		index.emplace(Key{data + pos, keyEnd - pos}, std::make_pair(valueStart, valueEnd));
+	}
+}
+
+void ConfigSource::close()
+{
+	if (data != nullptr) {
+#ifdef UTL_CONFIGSOURCE_MMAP
+		::munmap(const_cast<char*>(data), size);
+#else
+		delete[] data;
+#endif
+	}
+	data = nullptr;
+	size = 0;
+	opened = false;
+	index.clear();
+}
+
+} // namespace utl
+
+
+bool isBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
@@ -0,0 +1,149 @@
+#include "utl/log/bufferedlogcontext.h"
+
+#include <cassert>
+#include <utility>
+
+#include "utl/log/diagnosticcontext.h"
+#include "utl/log/logger.h"
+#include "utl/log/logrecord.h"
+
+
+namespace utl {
+namespace log {
+
+thread_local BufferedLogContext *BufferedLogContext::currentContext = nullptr;
+
+/**
+ * @brief Creates a context and attaches it to the current thread.
+ *
+ * @param flushLevel Records with at least this level pass the stored records
+ *        on.
+ * @param capacity The maximum number of bytes of logger names, messages and
+ *        diagnostic contexts which are stored.
+ */
+BufferedLogContext::BufferedLogContext(const LogLevel &flushLevel, std::size_t capacity) :
+	mFlushLevel(flushLevel),
+	mCapacity(capacity),
+	mDropped(0),
+	mFlushed(false),
+	mAttached(false),
+	mPrevious(nullptr)
+{
+	attach();
+}
+
+/**
+ * @brief Discards the stored records and detaches the context.
+ *
+ * The context must be attached to the current thread or not at all.
+ */
+BufferedLogContext::~BufferedLogContext()
+{
+	if (mAttached)
+		detach();
+}
+
+/**
+ * @brief Makes this context the current one of the calling thread.
+ *
+ * The previous context of the thread is restored by detach().
+ */
+void BufferedLogContext::attach()
+{
+	assert(!mAttached);
+	mPrevious = currentContext;
+	currentContext = this;
+	mAttached = true;
+}
+
+/**
+ * @brief Detaches the context from the calling thread.
+ *
+ * The stored records are kept, so the context can be attached to another
+ * thread. Contexts must be detached in the reverse order of attaching.
+ */
+void BufferedLogContext::detach()
+{
+	assert(mAttached && currentContext == this);
+	currentContext = mPrevious;
+	mPrevious = nullptr;
+	mAttached = false;
+}
+
+/**
+ * @brief Passes all stored records on to their loggers.
+ *
+ * Consecutive records of the same logger are passed on as one batch.
+ * Afterwards, records are not stored anymore until discard() is called.
+ */
+void BufferedLogContext::flush()
+{
+	mFlushed = true;
+	std::vector<LogRecord> batch;
+	for (std::size_t i = 0; i < mEntries.size(); ++i) {
+		const Entry &entry = mEntries[i];
+		batch.emplace_back();
+		LogRecord &record = batch.back();
+		record.loggerName.assign(mArena, entry.offset, entry.nameLength);
+		record.level = entry.level;
+		record.site = entry.site;
+		record.message.assign(mArena, entry.offset + entry.nameLength, entry.messageLength);
+		record.context.assign(mArena, entry.offset + entry.nameLength + entry.messageLength,
+				entry.contextLength);
+		if (i + 1 == mEntries.size() || mEntries[i + 1].logger != entry.logger) {
+			entry.logger->log(batch.data(), batch.size());
+			batch.clear();
+		}
+	}
+	mEntries.clear();
+	mArena.clear();
+}
+
+/**
+ * @brief Drops all stored records and starts to store records again.
+ *
+ * The memory of the context is kept, so it can be reused for the next unit
+ * of work without allocations.
+ */
+void BufferedLogContext::discard()
+{
+	mEntries.clear();
+	mArena.clear();
+	mDropped = 0;
+	mFlushed = false;
+}
+
+/**
+ * @brief Stores a record which passed the level of @p logger.
+ *
+ * This function is called by Logger::log(). If the record has at least the
+ * flush level, the stored records are passed on first.
+ *
+ * @return `true` if the record was consumed by the context, `false` if it
+ *         should be passed on by the caller.
+ */
+bool BufferedLogContext::buffer(const Logger &logger, const LogLevel &level,
+		const std::string &msg, const LogSite *site)
+{
+	if (mFlushed)
+		return false;
+	if (level >= mFlushLevel) {
+		flush();
+		return false;
+	}
+
+	const std::string &name = logger.mName;
+	if (mArena.size() + name.size() + msg.size() + DiagnosticContext::length() > mCapacity) {
+		++mDropped;
+		return true;
+	}
+	Entry entry = {logger.share(), level, site, mArena.size(), name.size(), msg.size(), 0};
+	mArena.append(name).append(msg);
+	DiagnosticContext::appendTo(mArena);
+	entry.contextLength = mArena.size() - entry.offset - entry.nameLength - entry.messageLength;
+	mEntries.push_back(std::move(entry));
+	return true;
+}
+
+} // namespace log
+} // namespace utl
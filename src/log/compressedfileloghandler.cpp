@@ -0,0 +1,47 @@
+#include "utl/log/compressedfileloghandler.h"
+
+#include "utl/log/logrecord.h"
+
+
+namespace utl {
+namespace log {
+
+CompressedFileLogHandler::CompressedFileLogHandler(const std::string &path,
+		std::size_t blockSize, const std::string &pattern) :
+	mFormatter(pattern),
+	mWriter(path, blockSize)
+{
+}
+
+CompressedFileLogHandler::~CompressedFileLogHandler()
+{
+}
+
+void CompressedFileLogHandler::flush()
+{
+	mWriter.flush();
+}
+
+void CompressedFileLogHandler::publish(const LogRecord &record)
+{
+	mWriter.write(format(record));
+}
+
+void CompressedFileLogHandler::publishBatch(const LogRecord *records, std::size_t count)
+{
+	std::string lines;
+	for (std::size_t i = 0; i < count; ++i)
+		lines += format(records[i]);
+	mWriter.write(lines);
+}
+
+std::string CompressedFileLogHandler::format(const LogRecord &record) const
+{
+	std::string line;
+	mFormatter.format(record, line);
+	line += '\n';
+	return line;
+}
+
+} // namespace log
+} // namespace utl
@@ -0,0 +1,99 @@
+#include "utl/log/compressedreader.h"
+
+#include <stdexcept>
+
+#include "utl/log/lz.h"
+
+
+namespace utl {
+namespace log {
+
+CompressedReader::CompressedReader(const std::string &path) :
+	mFile(path, std::ios::binary)
+{
+}
+
+bool CompressedReader::good() const
+{
+	return mFile.good();
+}
+
+/**
+ * @brief Reads and decompresses the next block.
+ *
+ * @param text The function will write the content of the block to this
+ *             parameter.
+ * @return `false` if there is no block left, `true` otherwise.
+ * @throws std::runtime_error If the file is corrupt.
+ */
+bool CompressedReader::nextBlock(std::string &text)
+{
+	bool compressed;
+	std::size_t rawSize, storedSize;
+	if (!readHeader(compressed, rawSize, storedSize))
+		return false;
+
+	mBuffer.resize(storedSize);
+	if (storedSize > 0 && !mFile.read(&mBuffer[0], storedSize))
+		throw std::runtime_error("truncated block in compressed log file");
+
+	text.clear();
+	if (!compressed) {
+		text.swap(mBuffer);
+	} else {
+		text.reserve(rawSize);
+		if (!lz::decompress(mBuffer.data(), mBuffer.size(), text))
+			throw std::runtime_error("corrupt block in compressed log file");
+	}
+	if (text.size() != rawSize)
+		throw std::runtime_error("corrupt block in compressed log file");
+	return true;
+}
+
+/**
+ * @brief Skips the next block without decompressing it.
+ * @return `false` if there is no block left, `true` otherwise.
+ * @throws std::runtime_error If the file is corrupt.
+ */
+bool CompressedReader::skipBlock()
+{
+	bool compressed;
+	std::size_t rawSize, storedSize;
+	if (!readHeader(compressed, rawSize, storedSize))
+		return false;
+	if (!mFile.seekg(storedSize, std::ios::cur))
+		throw std::runtime_error("truncated block in compressed log file");
+	return true;
+}
+
+/**
+ * @brief Decompresses all remaining blocks into the given stream.
+ * @throws std::runtime_error If the file is corrupt.
+ */
+void CompressedReader::copyTo(std::ostream &stream)
+{
+	std::string text;
+	while (nextBlock(text))
+		stream.write(text.data(), text.size());
+}
+
+bool CompressedReader::readHeader(bool &compressed, std::size_t &rawSize, std::size_t &storedSize)
+{
+	char raw[lz::BlockHeader::SIZE];
+	if (!mFile.read(raw, sizeof(raw))) {
+		if (mFile.gcount() == 0)
+			return false;
+		throw std::runtime_error("truncated header in compressed log file");
+	}
+
+	lz::BlockHeader header;
+	if (!header.read(raw))
+		throw std::runtime_error("invalid header in compressed log file");
+	compressed = header.compressed;
+	rawSize = header.rawSize;
+	storedSize = header.storedSize;
+	return true;
+}
+
+} // namespace log
+} // namespace utl
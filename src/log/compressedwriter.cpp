@@ -0,0 +1,129 @@
+#include "utl/log/compressedwriter.h"
+
+#include "utl/log/lz.h"
+
+
+namespace utl {
+namespace log {
+
+CompressedWriter::CompressedWriter(const std::string &path, std::size_t blockSize) :
+	mFile(path, std::ios::binary | std::ios::app),
+	mBlockSize(blockSize > 0 ? blockSize : 1),
+	mGood(mFile.good())
+{
+	mBlock.reserve(mBlockSize);
+	mThread = std::thread(&CompressedWriter::run, this);
+}
+
+CompressedWriter::~CompressedWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mBlock.empty())
+			mQueue.push_back(std::move(mBlock));
+		mStop = true;
+	}
+	mWork.notify_one();
+	mThread.join();
+}
+
+/**
+ * @brief Adds data to the current block.
+ *
+ * If the block is full afterwards, it is handed over to the background thread.
+ */
+void CompressedWriter::write(const char *data, std::size_t size)
+{
+	bool notify = false;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBlock.append(data, size);
+		mBytesIn += size;
+		if (mBlock.size() >= mBlockSize) {
+			mQueue.push_back(std::move(mBlock));
+			mBlock = std::string();
+			mBlock.reserve(mBlockSize);
+			notify = true;
+		}
+	}
+	if (notify)
+		mWork.notify_one();
+}
+
+/**
+ * @brief Closes the current block and waits until everything is written.
+ */
+void CompressedWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mBlock.empty()) {
+		mQueue.push_back(std::move(mBlock));
+		mBlock = std::string();
+		mBlock.reserve(mBlockSize);
+	}
+	mWork.notify_one();
+	mIdle.wait(lock, [this] { return mQueue.empty() && !mBusy; });
+}
+
+bool CompressedWriter::good() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mGood;
+}
+
+std::size_t CompressedWriter::getBytesIn() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBytesIn;
+}
+
+std::size_t CompressedWriter::getBytesOut() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBytesOut;
+}
+
+void CompressedWriter::run()
+{
+	std::string out;
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mWork.wait(lock, [this] { return mStop || !mQueue.empty(); });
+		if (mQueue.empty()) {
+			// mStop is set and there is nothing left to do
+			break;
+		}
+
+		std::string block = std::move(mQueue.front());
+		mQueue.pop_front();
+		mBusy = true;
+		lock.unlock();
+
+		out.assign(lz::BlockHeader::SIZE, '\0');
+		lz::compress(block.data(), block.size(), out);
+		lz::BlockHeader header;
+		header.compressed = out.size() - lz::BlockHeader::SIZE < block.size();
+		header.rawSize = static_cast<std::uint32_t>(block.size());
+		if (!header.compressed) {
+			// Compression did not help, store the block as it is
+			out.resize(lz::BlockHeader::SIZE);
+			out += block;
+		}
+		header.storedSize = static_cast<std::uint32_t>(out.size() - lz::BlockHeader::SIZE);
+		header.write(&out[0]);
+
+		mFile.write(out.data(), out.size());
+		mFile.flush();
+
+		lock.lock();
+		mBusy = false;
+		mGood = mGood && mFile.good();
+		mBytesOut += out.size();
+		if (mQueue.empty())
+			mIdle.notify_all();
+	}
+	mIdle.notify_all();
+}
+
+} // namespace log
+} // namespace utl
@@ -1,7 +1,6 @@
 #include "utl/log/consoleloghandler.h"
 
 #include <iostream>
-#include <sstream>
 #include <stdio.h>
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
@@ -15,14 +14,18 @@
 #include "utl/log/logrecord.h"
 
 using std::cerr;
-using std::endl;
 
 
 namespace utl {
 namespace log {
 
-ConsoleLogHandler::ConsoleLogHandler() :
-	mIsTTY(isatty(fileno(stderr)))
+ConsoleLogHandler::ConsoleLogHandler(const std::string &pattern) :
+	mIsTTY(isatty(fileno(stderr))),
+#if defined(unix) || defined(__unix__) || defined(__unix)
+	mFormatter(pattern, mIsTTY)
+#else
+	mFormatter(pattern, false)
+#endif
 {
 }
 
@@ -32,35 +35,24 @@ ConsoleLogHandler::~ConsoleLogHandler()
 
 void ConsoleLogHandler::publish(const LogRecord &record)
 {
-	std::string colorLevel, colorLogger, colorEnd;
-#if defined(unix) || defined(__unix__) || defined(__unix)
-	if (mIsTTY) {
-		colorEnd = "\x1b[0m";
-		colorLogger = "\x1b[1m";
-
-		if (record.level <= LogLevel::INFO)
-			colorLevel = "\x1b[32m";
-		else if (record.level <= LogLevel::WARNING)
-			colorLevel = "\x1b[33m";
-		else
-			colorLevel = "\x1b[31m";
-	}
-#endif
-
-	auto lineEnd = record.message.find_first_of('\n');
-
-	std::stringstream obuf;
-	obuf << "[" << colorLevel << record.level << colorEnd << "]"
-			"[" << colorLogger << record.loggerName << colorEnd << "] "
-		 << record.message.substr(0, lineEnd);
+	thread_local std::string buffer;
+	buffer.clear();
+	mFormatter.format(record, buffer);
+	buffer += '\n';
+	cerr.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	cerr.flush();
+}
 
-	while (lineEnd != std::string::npos) {
-		auto lineStart = lineEnd + 1;
-		lineEnd = record.message.find_first_of('\n', lineStart);
-		obuf << "\n    " << record.message.substr(lineStart, lineEnd - lineStart);
+void ConsoleLogHandler::publishBatch(const LogRecord *records, std::size_t count)
+{
+	thread_local std::string buffer;
+	buffer.clear();
+	for (std::size_t i = 0; i < count; ++i) {
+		mFormatter.format(records[i], buffer);
+		buffer += '\n';
 	}
-
-	cerr << obuf.str() << std::endl;
+	cerr.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	cerr.flush();
 }
 
 } // namespace log
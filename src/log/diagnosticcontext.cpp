@@ -0,0 +1,123 @@
+#include "utl/log/diagnosticcontext.h"
+
+#include <cassert>
+#include <cstring>
+
+
+namespace {
+
+/**
+ * The pairs of a thread, rendered into one buffer. Every entry remembers
+ * where its text starts, so popping only truncates the buffer.
+ */
+struct Stack {
+	struct Entry {
+		const char *key;
+		std::size_t start;
+		std::size_t valueStart;
+	};
+
+	char text[utl::log::DiagnosticContext::MAX_LENGTH];
+	std::size_t length;
+	Entry entries[utl::log::DiagnosticContext::MAX_ENTRIES];
+	std::size_t depth;
+};
+
+thread_local Stack stack;
+
+} // namespace
+
+
+namespace utl {
+namespace log {
+
+const std::size_t DiagnosticContext::MAX_ENTRIES;
+const std::size_t DiagnosticContext::MAX_LENGTH;
+
+/**
+ * @brief Pushes a pair onto the context of the current thread.
+ *
+ * Prefer a Guard, which pops the pair automatically.
+ *
+ * @return `true` if the pair was pushed, `false` if the context is full.
+ */
+bool DiagnosticContext::push(const char *key, const char *value, std::size_t length)
+{
+	std::size_t keyLength = std::strlen(key);
+	std::size_t separator = (stack.depth > 0) ? 1 : 0;
+	if (stack.depth == MAX_ENTRIES ||
+			stack.length + separator + keyLength + 1 + length > MAX_LENGTH)
+		return false;
+
+	Stack::Entry &entry = stack.entries[stack.depth++];
+	entry.key = key;
+	entry.start = stack.length;
+	char *pos = stack.text + stack.length;
+	if (separator)
+		*pos++ = ' ';
+	std::memcpy(pos, key, keyLength);
+	pos += keyLength;
+	*pos++ = '=';
+	entry.valueStart = static_cast<std::size_t>(pos - stack.text);
+	std::memcpy(pos, value, length);
+	stack.length = entry.valueStart + length;
+	return true;
+}
+
+/**
+ * @brief Removes the pair pushed last from the context of the current thread.
+ */
+void DiagnosticContext::pop()
+{
+	assert(stack.depth > 0);
+	stack.length = stack.entries[--stack.depth].start;
+}
+
+/**
+ * @brief Returns the number of pairs of the current thread.
+ */
+std::size_t DiagnosticContext::depth()
+{
+	return stack.depth;
+}
+
+/**
+ * @brief Returns the number of characters appendTo() appends.
+ */
+std::size_t DiagnosticContext::length()
+{
+	return stack.length;
+}
+
+/**
+ * @brief Looks up the innermost value of @p key in the current thread.
+ *
+ * @return `true` if the key was found, `false` otherwise.
+ */
+bool DiagnosticContext::get(const std::string &key, std::string &value)
+{
+	for (std::size_t i = stack.depth; i > 0; --i) {
+		const Stack::Entry &entry = stack.entries[i - 1];
+		if (key == entry.key) {
+			std::size_t end = (i < stack.depth) ? stack.entries[i].start : stack.length;
+			value.assign(stack.text + entry.valueStart, end - entry.valueStart);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Appends the pairs of the current thread to @p str.
+ *
+ * The pairs are separated by spaces, like `request=42 tenant=acme`. Nothing
+ * is appended if the context is empty.
+ */
+void DiagnosticContext::appendTo(std::string &str)
+{
+	if (stack.length > 0)
+		str.append(stack.text, stack.length);
+}
+
+} // namespace log
+} // namespace utl
@@ -0,0 +1,509 @@
+#include "utl/log/flightrecorderloghandler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+#include <signal.h>
+#include <unistd.h>
+#define UTL_FLIGHTRECORDER_SIGNALS 1
+#elif defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+#include <io.h>
+#define write _write
+#endif
+
+namespace {
+
+/**
+ * The state of a ring buffer which is shared between its handler and the
+ * thread which writes to it.
+ */
+struct RingOwnership {
+	// set while a thread writes to the ring
+	std::atomic<bool> owned;
+	// set when the handler is destroyed
+	std::atomic<bool> detached;
+
+	RingOwnership() : owned(true), detached(false) {}
+};
+
+struct CachedRing {
+	std::uint64_t handler;
+	std::shared_ptr<RingOwnership> ring;
+};
+
+/**
+ * The ring buffers of the current thread, by id of the handler. They are
+ * given back to their handlers when the thread exits.
+ */
+struct ThreadRings {
+	~ThreadRings() {
+		for (const CachedRing &cached : rings)
+			cached.ring->owned.store(false, std::memory_order_release);
+	}
+
+	std::vector<CachedRing> rings;
+};
+thread_local ThreadRings threadRings;
+
+std::atomic<std::uint64_t> nextId(1);
+
+/**
+ * Collects output in a fixed buffer and writes it with write(2), so it can
+ * be used in a signal handler.
+ */
+class FdWriter
+{
+public:
+	explicit FdWriter(int fd) : mFd(fd), mLength(0) {}
+	~FdWriter() { flush(); }
+
+	void put(char c) {
+		if (mLength == sizeof(mBuffer))
+			flush();
+		mBuffer[mLength++] = c;
+	}
+	void put(const char *str) {
+		for (; *str != '\0'; ++str)
+			put(*str);
+	}
+	void put(int value) {
+		char digits[12];
+		std::size_t n = 0;
+		unsigned int u = (value < 0) ? 0u - static_cast<unsigned int>(value) : value;
+		do {
+			digits[n++] = static_cast<char>('0' + u % 10);
+			u /= 10;
+		} while (u != 0);
+		if (value < 0)
+			put('-');
+		while (n > 0)
+			put(digits[--n]);
+	}
+	void flush() {
+		const char *data = mBuffer;
+		while (mLength > 0) {
+			auto written = ::write(mFd, data, static_cast<unsigned int>(mLength));
+			if (written <= 0)
+				break;
+			data += written;
+			mLength -= static_cast<std::size_t>(written);
+		}
+		mLength = 0;
+	}
+
+private:
+	int mFd;
+	char mBuffer[512];
+	std::size_t mLength;
+};
+
+} // namespace
+
+
+
+namespace utl {
+namespace log {
+
+/**
+ * The ring buffer of one thread. Only the owning thread writes to it. The
+ * version is odd while a record is written, so readers in other threads can
+ * detect a concurrent write (like a sequence lock).
+ */
+struct FlightRecorderLogHandler::Ring : RingOwnership {
+	explicit Ring(std::size_t capacity) :
+		data(new char[capacity]), capacity(capacity), head(0), tail(0), version(0)
+	{}
+
+	void copyIn(std::uint64_t pos, const void *src, std::size_t n) {
+		std::size_t offset = static_cast<std::size_t>(pos % capacity);
+		std::size_t first = std::min(n, capacity - offset);
+		std::memcpy(data.get() + offset, src, first);
+		std::memcpy(data.get(), static_cast<const char*>(src) + first, n - first);
+	}
+
+	std::unique_ptr<char[]> data;
+	const std::size_t capacity;
+	std::atomic<std::uint64_t> head;
+	std::atomic<std::uint64_t> tail;
+	std::atomic<std::uint64_t> version;
+};
+
+const std::size_t FlightRecorderLogHandler::MAX_THREADS;
+
+#ifdef UTL_FLIGHTRECORDER_SIGNALS
+static FlightRecorderLogHandler *volatile signalTargets[NSIG];
+static int signalFds[NSIG];
+static struct sigaction previousActions[NSIG];
+#endif
+
+
+/**
+ * @brief Creates a flight recorder.
+ *
+ * @param target The handler the records are passed to by dump().
+ * @param bytesPerThread The size of the ring buffer of every thread.
+ */
+FlightRecorderLogHandler::FlightRecorderLogHandler(std::shared_ptr<LogHandler> target,
+		std::size_t bytesPerThread) :
+	mId(nextId.fetch_add(1)),
+	mTarget(target),
+	mBytesPerThread(std::max(bytesPerThread, sizeof(Entry) + 64)),
+	mDumpLevel(LogLevel::SEVERE),
+	mRingCount(0),
+	mDropped(0),
+	mDumpedUntil(-1),
+	mEpoch(std::chrono::steady_clock::now())
+{
+	for (std::atomic<Ring*> &ring : mRings)
+		ring.store(nullptr, std::memory_order_relaxed);
+}
+
+FlightRecorderLogHandler::~FlightRecorderLogHandler()
+{
+#ifdef UTL_FLIGHTRECORDER_SIGNALS
+	for (int signal = 1; signal < NSIG; ++signal) {
+		if (signalTargets[signal] == this)
+			dumpOnSignal(nullptr, signal);
+	}
+#endif
+	// Threads which still hold a ring drop it with their next record
+	for (const std::shared_ptr<Ring> &ring : mRingOwners) {
+		if (ring)
+			ring->detached.store(true, std::memory_order_relaxed);
+	}
+}
+
+void FlightRecorderLogHandler::publish(const LogRecord &record)
+{
+	Ring *ring = this->ring();
+	if (ring == nullptr) {
+		mDropped.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		std::size_t maxPayload = ring->capacity - sizeof(Entry);
+		// The frames get at most half of the space, the outermost are dropped
+		std::size_t frameCount = record.stackTrace ? std::min(record.stackTrace->size(),
+				maxPayload / 2 / sizeof(void*)) : 0;
+		maxPayload -= frameCount * sizeof(void*);
+		Entry entry;
+		entry.level = static_cast<int>(record.level);
+		entry.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - mEpoch).count();
+		entry.nameLength = static_cast<std::uint32_t>(std::min(record.loggerName.size(), maxPayload));
+		entry.messageLength = static_cast<std::uint32_t>(std::min(record.message.size(),
+				maxPayload - entry.nameLength));
+		entry.contextLength = static_cast<std::uint32_t>(std::min(record.context.size(),
+				maxPayload - entry.nameLength - entry.messageLength));
+		entry.frameCount = static_cast<std::uint32_t>(frameCount);
+		entry.site = record.site;
+		entry.size = static_cast<std::uint32_t>(sizeof(Entry) + entry.nameLength +
+				entry.messageLength + entry.contextLength + frameCount * sizeof(void*));
+
+		std::uint64_t version = ring->version.load(std::memory_order_relaxed);
+		ring->version.store(version + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		// Drop the oldest records until the new one fits
+		std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+		std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+		View view = {ring->data.get(), ring->capacity, tail, head};
+		while (head + entry.size - tail > ring->capacity) {
+			Entry old;
+			view.copyOut(tail, &old, sizeof(old));
+			tail += old.size;
+		}
+		ring->tail.store(tail, std::memory_order_relaxed);
+
+		ring->copyIn(head, &entry, sizeof(entry));
+		ring->copyIn(head + sizeof(entry), record.loggerName.data(), entry.nameLength);
+		std::uint64_t at = head + sizeof(entry) + entry.nameLength;
+		ring->copyIn(at, record.message.data(), entry.messageLength);
+		at += entry.messageLength;
+		ring->copyIn(at, record.context.data(), entry.contextLength);
+		at += entry.contextLength;
+		if (frameCount > 0)
+			ring->copyIn(at, record.stackTrace->data(), frameCount * sizeof(void*));
+		ring->head.store(head + entry.size, std::memory_order_relaxed);
+		ring->version.store(version + 2, std::memory_order_release);
+	}
+
+	if (record.level >= mDumpLevel)
+		dump();
+}
+
+/**
+ * @brief Passes all records which were not dumped yet to the target handler.
+ *
+ * The records are passed in one batch.
+ */
+void FlightRecorderLogHandler::dump()
+{
+	std::lock_guard<std::mutex> lock(mDumpMutex);
+
+	// Take a consistent copy of every ring buffer
+	View views[MAX_THREADS];
+	std::vector<std::unique_ptr<char[]>> copies;
+	std::size_t count = 0;
+	std::size_t rings = std::min(mRingCount.load(), MAX_THREADS);
+	for (std::size_t i = 0; i < rings; ++i) {
+		Ring *ring = mRings[i].load(std::memory_order_acquire);
+		if (ring == nullptr)
+			continue;
+		std::unique_ptr<char[]> copy(new char[ring->capacity]);
+		for (int attempt = 0; attempt < 1000; ++attempt) {
+			std::uint64_t version = ring->version.load(std::memory_order_acquire);
+			if (version % 2 == 1) {
+				std::this_thread::yield();
+				continue;
+			}
+			View view = {copy.get(), ring->capacity,
+					ring->tail.load(std::memory_order_relaxed),
+					ring->head.load(std::memory_order_relaxed)};
+			std::memcpy(copy.get(), ring->data.get(), ring->capacity);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (ring->version.load(std::memory_order_relaxed) == version) {
+				views[count++] = view;
+				copies.push_back(std::move(copy));
+				break;
+			}
+		}
+	}
+
+	std::vector<LogRecord> records;
+	merge(views, count, [&records](const View &view, const Entry &entry) {
+		records.emplace_back();
+		LogRecord &record = records.back();
+		std::uint64_t pos = view.pos + sizeof(Entry);
+		record.loggerName.resize(entry.nameLength);
+		view.copyOut(pos, &record.loggerName[0], entry.nameLength);
+		pos += entry.nameLength;
+		record.message.resize(entry.messageLength);
+		view.copyOut(pos, &record.message[0], entry.messageLength);
+		pos += entry.messageLength;
+		record.context.resize(entry.contextLength);
+		view.copyOut(pos, &record.context[0], entry.contextLength);
+		pos += entry.contextLength;
+		if (entry.frameCount > 0) {
+			void *frames[StackTrace::MAX_DEPTH];
+			view.copyOut(pos, frames, entry.frameCount * sizeof(void*));
+			std::shared_ptr<StackTrace> trace = std::make_shared<StackTrace>();
+			trace->assign(frames, entry.frameCount);
+			record.stackTrace = std::move(trace);
+		}
+		record.level = LogLevel(entry.level);
+		record.site = entry.site;
+	});
+	mTarget->handleBatch(records.data(), records.size());
+}
+
+/**
+ * @brief Writes all records which were not dumped yet to a file descriptor.
+ *
+ * The records are written like `[LEVEL][logger][context] message`, without
+ * their stack traces. The function does not allocate memory and does not
+ * take locks, so it can be called from a signal handler. Records which are
+ * written by other threads at the same time may be garbled. If an entry is
+ * overwritten while it is read, the remaining records of its thread are
+ * skipped.
+ */
+void FlightRecorderLogHandler::dump(int fd)
+{
+	View views[MAX_THREADS];
+	std::size_t count = 0;
+	std::size_t rings = std::min(mRingCount.load(), MAX_THREADS);
+	for (std::size_t i = 0; i < rings; ++i) {
+		Ring *ring = mRings[i].load(std::memory_order_acquire);
+		if (ring != nullptr) {
+			View view = {ring->data.get(), ring->capacity,
+					ring->tail.load(std::memory_order_acquire),
+					ring->head.load(std::memory_order_acquire)};
+			views[count++] = view;
+		}
+	}
+
+	FdWriter out(fd);
+	merge(views, count, [&out](const View &view, const Entry &entry) {
+		out.put('[');
+		if (const char *name = LogLevel(entry.level).getName())
+			out.put(name);
+		else
+			out.put(static_cast<int>(entry.level));
+		out.put("][");
+		std::uint64_t pos = view.pos + sizeof(Entry);
+		copyText(out, view, pos, entry.nameLength);
+		out.put(']');
+		if (entry.contextLength > 0) {
+			out.put('[');
+			copyText(out, view, pos + entry.nameLength + entry.messageLength,
+					entry.contextLength);
+			out.put(']');
+		}
+		out.put(' ');
+		copyText(out, view, pos + entry.nameLength, entry.messageLength);
+		out.put('\n');
+	});
+}
+
+/**
+ * Writes @p length characters of a ring buffer and indents continuation lines.
+ */
+template<typename Writer>
+void FlightRecorderLogHandler::copyText(Writer &out, const View &view, std::uint64_t pos,
+		std::size_t length)
+{
+	char chunk[128];
+	while (length > 0) {
+		std::size_t n = std::min(length, sizeof(chunk));
+		view.copyOut(pos, chunk, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			out.put(chunk[i]);
+			if (chunk[i] == '\n')
+				out.put("    ");
+		}
+		pos += n;
+		length -= n;
+	}
+}
+
+FlightRecorderLogHandler::Ring *FlightRecorderLogHandler::ring()
+{
+	std::vector<CachedRing> &cached = threadRings.rings;
+	for (auto it = cached.begin(); it != cached.end(); ) {
+		if (it->ring->detached.load(std::memory_order_relaxed)) {
+			it = cached.erase(it);
+		} else if (it->handler == mId) {
+			return static_cast<Ring*>(it->ring.get());
+		} else {
+			++it;
+		}
+	}
+
+	// First record of this thread, take the ring of a finished thread
+	std::shared_ptr<Ring> ring;
+	std::size_t rings = std::min(mRingCount.load(), MAX_THREADS);
+	for (std::size_t i = 0; i < rings && !ring; ++i) {
+		Ring *candidate = mRings[i].load(std::memory_order_acquire);
+		bool owned = false;
+		if (candidate != nullptr && !candidate->owned.load(std::memory_order_relaxed) &&
+				candidate->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+			ring = mRingOwners[i];
+	}
+	if (!ring) {
+		std::size_t idx = mRingCount.fetch_add(1);
+		if (idx >= MAX_THREADS)
+			return nullptr;
+		ring = std::make_shared<Ring>(mBytesPerThread);
+		mRingOwners[idx] = ring;
+		mRings[idx].store(ring.get(), std::memory_order_release);
+	}
+	cached.push_back(CachedRing{mId, ring});
+	return ring.get();
+}
+
+/**
+ * @brief Calls @p func for all records newer than the last dump, ordered by
+ * time.
+ */
+template<typename F>
+void FlightRecorderLogHandler::merge(View *views, std::size_t count, F func)
+{
+	std::int64_t from = mDumpedUntil.load();
+	std::int64_t last = from;
+	Entry entry;
+	for (std::size_t i = 0; i < count; ++i) {
+		while (views[i].peek(entry) && entry.time <= from)
+			views[i].pos += entry.size;
+	}
+
+	while (true) {
+		View *next = nullptr;
+		Entry nextEntry;
+		for (std::size_t i = 0; i < count; ++i) {
+			if (views[i].peek(entry) && (next == nullptr || entry.time < nextEntry.time)) {
+				next = &views[i];
+				nextEntry = entry;
+			}
+		}
+		if (next == nullptr)
+			break;
+		func(*next, nextEntry);
+		next->pos += nextEntry.size;
+		last = std::max(last, nextEntry.time);
+	}
+
+	// Remember the last dumped record
+	while (from < last && !mDumpedUntil.compare_exchange_weak(from, last)) {
+	}
+}
+
+#ifdef UTL_FLIGHTRECORDER_SIGNALS
+
+static void onSignal(int signal, siginfo_t *info, void *context)
+{
+	if (FlightRecorderLogHandler *handler = signalTargets[signal])
+		handler->dump(signalFds[signal]);
+
+	const struct sigaction &previous = previousActions[signal];
+	if (previous.sa_flags & SA_SIGINFO) {
+		previous.sa_sigaction(signal, info, context);
+	} else if (previous.sa_handler == SIG_DFL) {
+		if (signal != SIGUSR1 && signal != SIGUSR2) {
+			sigaction(signal, &previous, nullptr);
+			raise(signal);
+		}
+	} else if (previous.sa_handler != SIG_IGN) {
+		previous.sa_handler(signal);
+	}
+}
+
+/**
+ * @brief Dumps the records of @p handler when @p signal is received.
+ *
+ * The records are written to @p fd with dump(int). Afterwards, the previous
+ * action of the signal is performed. If it was the default action, the
+ * program is terminated as usual, except for `SIGUSR1` and `SIGUSR2`, which
+ * only trigger the dump.
+ *
+ * If @p handler is `nullptr`, the previous action is restored. A handler
+ * removes itself when it is destroyed.
+ *
+ * This function does nothing on systems other than Unix.
+ */
+void FlightRecorderLogHandler::dumpOnSignal(FlightRecorderLogHandler *handler, int signal, int fd)
+{
+	if (signal <= 0 || signal >= NSIG)
+		return;
+
+	if (handler == nullptr) {
+		if (signalTargets[signal] != nullptr) {
+			signalTargets[signal] = nullptr;
+			sigaction(signal, &previousActions[signal], nullptr);
+		}
+		return;
+	}
+
+	bool installed = (signalTargets[signal] != nullptr);
+	signalFds[signal] = fd;
+	signalTargets[signal] = handler;
+	if (!installed) {
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_sigaction = onSignal;
+		action.sa_flags = SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+		sigaction(signal, &action, &previousActions[signal]);
+	}
+}
+
+#else
+
+void FlightRecorderLogHandler::dumpOnSignal(FlightRecorderLogHandler*, int, int)
+{
+}
+
+#endif
+
+} // namespace log
+} // namespace utl
@@ -6,8 +6,124 @@ namespace log {
 
 Logger Logger::root (nullptr);
 std::shared_ptr<Logger> Logger::rootSharedPtr (&Logger::root, [](Logger*){});
-std::unordered_map<std::string, std::shared_ptr<Logger>> Logger::globalLoggers;
+Logger::LoggerList Logger::recentLoggers;
+std::unordered_map<std::string, Logger::LoggerList::iterator> Logger::globalLoggers;
+std::size_t Logger::registryLimit = 0;
 std::mutex Logger::staticMutex;
 
+/**
+ * @brief Returns the logger with the name @p name, which is created if
+ * necessary. The root logger is returned for an empty name.
+ */
+std::shared_ptr<Logger> Logger::getP(const std::string &name)
+{
+	// use global logger if the name is empty
+	if (name.empty())
+		return Logger::rootSharedPtr;
+	// lock to secure the map (globalLoggers)
+	// TODO use a lock which supports concurrent reads?
+	std::lock_guard<std::mutex> lock(staticMutex);
+	auto it = globalLoggers.find(name);
+	if (it != globalLoggers.end()) {
+		if (registryLimit != 0)
+			recentLoggers.splice(recentLoggers.begin(), recentLoggers, it->second);
+		return *it->second;
+	}
+
+	// logger is new, setup
+	// TODO setup from configuration, if available
+	std::shared_ptr<Logger> logger = std::make_shared<Logger>(rootSharedPtr);
+	logger->mName = name;
+	recentLoggers.push_front(logger);
+	globalLoggers.emplace(name, recentLoggers.begin());
+	if (registryLimit != 0 && globalLoggers.size() > registryLimit)
+		evict(globalLoggers.size() - registryLimit);
+	return logger;
+}
+
+/**
+ * @brief Removes all loggers from the registry which are not used anymore.
+ *
+ * A logger is removed if no shared pointer outside of the registry refers to
+ * it and it was never configured (its level was not set and no handler was
+ * added). Such a logger is created again by the next call of get(), with
+ * the settings of the root logger. References returned by get() are not
+ * counted, so they must not be kept across a sweep.
+ *
+ * @return The number of removed loggers.
+ */
+std::size_t Logger::sweep()
+{
+	std::lock_guard<std::mutex> lock(staticMutex);
+	return evict(globalLoggers.size());
+}
+
+std::size_t Logger::getRegistryLimit()
+{
+	std::lock_guard<std::mutex> lock(staticMutex);
+	return registryLimit;
+}
+
+/**
+ * @brief Bounds the number of loggers in the registry.
+ *
+ * If a new logger exceeds the limit, the least recently used loggers which
+ * could be removed by sweep() are evicted. Loggers which are configured or
+ * referenced are kept, even if the registry then exceeds the limit. `0`
+ * disables the limit, which is the default.
+ *
+ * Since a reference returned by get() does not keep its logger alive, it can
+ * be evicted by another thread at any time once a limit is set. Code which
+ * runs with a limit must hold its loggers with getP().
+ */
+void Logger::setRegistryLimit(std::size_t limit)
+{
+	std::lock_guard<std::mutex> lock(staticMutex);
+	registryLimit = limit;
+	if (registryLimit != 0 && globalLoggers.size() > registryLimit)
+		evict(globalLoggers.size() - registryLimit);
+}
+
+std::size_t Logger::getRegistrySize()
+{
+	std::lock_guard<std::mutex> lock(staticMutex);
+	return globalLoggers.size();
+}
+
+/**
+ * Returns a shared pointer which keeps this logger alive. A logger which is
+ * not owned by a shared pointer (like one on the stack) is referenced
+ * without ownership, it must outlive the returned pointer.
+ */
+std::shared_ptr<const Logger> Logger::share() const
+{
+	try {
+		return shared_from_this();
+	} catch (const std::bad_weak_ptr&) {
+		return std::shared_ptr<const Logger>(std::shared_ptr<const Logger>(), this);
+	}
+}
+
+/**
+ * Removes up to @p count unused loggers, starting with the least recently
+ * used one. The static mutex must be locked.
+ */
+std::size_t Logger::evict(std::size_t count)
+{
+	std::size_t evicted = 0;
+	auto it = recentLoggers.end();
+	while (evicted < count && it != recentLoggers.begin()) {
+		--it;
+		const std::shared_ptr<Logger> &logger = *it;
+		// Nobody else can get a new reference while the mutex is locked
+		if (logger.use_count() == 1 && !logger->mConfigured) {
+			globalLoggers.erase(logger->mName);
+			it = recentLoggers.erase(it);
+			++evicted;
+		}
+	}
+	return evicted;
+}
+
 } // namespace log
 } // namespace utl
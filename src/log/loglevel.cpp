@@ -1,18 +1,118 @@
 #include "utl/log/loglevel.h"
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+static const char *predefinedName(int value) noexcept;
+
+/**
+ * The registered names. Entries are only appended and never changed, so
+ * readers need no lock and the names stay valid forever. All of this is
+ * constant initialized.
+ */
+struct Registration {
+	int value;
+	const char *name;
+};
+
+static Registration registrations[utl::log::LogLevel::MAX_REGISTERED_NAMES];
+static std::atomic<std::size_t> registrationCount(0);
+static std::mutex registrationMutex;
+
 
 namespace utl {
 namespace log {
 
 const LogLevel LogLevel::ALL     (INT_MIN);
-const LogLevel LogLevel::FINEST  (    300, "FINEST" );
-const LogLevel LogLevel::FINER   (    400, "FINER"  );
-const LogLevel LogLevel::FINE    (    500, "FINE"   );
-const LogLevel LogLevel::CONFIG  (    700, "CONFIG" );
-const LogLevel LogLevel::INFO    (    800, "INFO"   );
-const LogLevel LogLevel::WARNING (    900, "WARNING");
-const LogLevel LogLevel::SEVERE  (   1000, "SEVERE" );
+const LogLevel LogLevel::FINEST  (    300);
+const LogLevel LogLevel::FINER   (    400);
+const LogLevel LogLevel::FINE    (    500);
+const LogLevel LogLevel::CONFIG  (    700);
+const LogLevel LogLevel::INFO    (    800);
+const LogLevel LogLevel::WARNING (    900);
+const LogLevel LogLevel::SEVERE  (   1000);
 const LogLevel LogLevel::OFF     (INT_MAX);
 
+const std::size_t LogLevel::MAX_REGISTERED_NAMES;
+
+/**
+ * @brief Creates a level and registers @p name for its value.
+ *
+ * @throw std::invalid_argument If the value already has another name or
+ *        MAX_REGISTERED_NAMES names are registered.
+ * @see registerName()
+ */
+LogLevel::LogLevel(int value, const std::string &name) :
+	mValue(value)
+{
+	if (!registerName(value, name))
+		throw std::invalid_argument("cannot register log level name " + name);
+}
+
+/**
+ * @brief Returns the name of the level, or `nullptr` if it has none.
+ *
+ * The function neither allocates memory nor takes locks, so it can be
+ * called from a signal handler.
+ */
+const char *LogLevel::getName() const noexcept
+{
+	if (const char *name = predefinedName(mValue))
+		return name;
+	std::size_t count = registrationCount.load(std::memory_order_acquire);
+	for (std::size_t i = 0; i < count; ++i) {
+		if (registrations[i].value == mValue)
+			return registrations[i].name;
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Gives all levels with the value @p value the name @p name.
+ *
+ * A name can only be registered once for every value, the names of the
+ * predefined levels cannot be changed.
+ *
+ * @return `true` if @p name is the name of the value now, `false` if the
+ *         value already has another name or MAX_REGISTERED_NAMES names are
+ *         registered.
+ */
+bool LogLevel::registerName(int value, const std::string &name)
+{
+	std::lock_guard<std::mutex> lock(registrationMutex);
+	if (const char *current = LogLevel(value).getName())
+		return name == current;
+
+	std::size_t count = registrationCount.load(std::memory_order_relaxed);
+	if (count == MAX_REGISTERED_NAMES)
+		return false;
+	char *copy = new char[name.size() + 1];
+	std::memcpy(copy, name.c_str(), name.size() + 1);
+	registrations[count].value = value;
+	registrations[count].name = copy;
+	registrationCount.store(count + 1, std::memory_order_release);
+	return true;
+}
+
 } // namespace log
 } // namespace utl
+
+
+/**
+ * Returns the name of a predefined level, or `nullptr`.
+ */
+const char *predefinedName(int value) noexcept
+{
+	switch (value) {
+	case  300: return "FINEST";
+	case  400: return "FINER";
+	case  500: return "FINE";
+	case  700: return "CONFIG";
+	case  800: return "INFO";
+	case  900: return "WARNING";
+	case 1000: return "SEVERE";
+	default:   return nullptr;
+	}
+}
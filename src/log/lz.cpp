@@ -0,0 +1,180 @@
+#include "utl/log/lz.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const unsigned HASH_BITS = 12;
+static const std::size_t MIN_MATCH = 4;
+static const std::size_t MAX_OFFSET = 0xFFFF;
+// The last bytes of a block are always emitted as literals
+static const std::size_t TAIL_LITERALS = 5;
+static const char MAGIC[3] = {'U', 'L', 'Z'};
+
+static inline std::uint32_t read32(const char *p)
+{
+	std::uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline std::uint32_t hash(std::uint32_t seq)
+{
+	return (seq * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void putLength(std::string &out, std::size_t len)
+{
+	while (len >= 255) {
+		out.push_back(static_cast<char>(255));
+		len -= 255;
+	}
+	out.push_back(static_cast<char>(len));
+}
+
+static bool getLength(const unsigned char *&ip, const unsigned char *end, std::size_t &len)
+{
+	unsigned char c;
+	do {
+		if (ip == end)
+			return false;
+		c = *ip++;
+		len += c;
+	} while (c == 255);
+	return true;
+}
+
+static void putSequence(std::string &out, const char *lit, std::size_t litLen,
+		std::size_t offset, std::size_t matchLen)
+{
+	std::size_t m = matchLen - MIN_MATCH;
+	unsigned char token = static_cast<unsigned char>(
+			(std::min<std::size_t>(litLen, 15) << 4) | std::min<std::size_t>(m, 15));
+	out.push_back(static_cast<char>(token));
+	if (litLen >= 15)
+		putLength(out, litLen - 15);
+	out.append(lit, litLen);
+	out.push_back(static_cast<char>(offset & 0xFF));
+	out.push_back(static_cast<char>(offset >> 8));
+	if (m >= 15)
+		putLength(out, m - 15);
+}
+
+static void putLiterals(std::string &out, const char *lit, std::size_t litLen)
+{
+	out.push_back(static_cast<char>(std::min<std::size_t>(litLen, 15) << 4));
+	if (litLen >= 15)
+		putLength(out, litLen - 15);
+	out.append(lit, litLen);
+}
+
+
+namespace utl {
+namespace log {
+namespace lz {
+
+/**
+ * @brief Compresses a block of data and appends the result to @p out.
+ */
+void compress(const char *src, std::size_t size, std::string &out)
+{
+	std::uint32_t table[1u << HASH_BITS];
+	std::fill(table, table + (1u << HASH_BITS), UINT32_MAX);
+
+	out.reserve(out.size() + size + size / 255 + 16);
+
+	std::size_t anchor = 0, ip = 0;
+	while (ip + MIN_MATCH + TAIL_LITERALS < size) {
+		std::uint32_t seq = read32(src + ip);
+		std::uint32_t &slot = table[hash(seq)];
+		std::size_t ref = slot;
+		slot = static_cast<std::uint32_t>(ip);
+
+		if (ref == UINT32_MAX || ip - ref > MAX_OFFSET || read32(src + ref) != seq) {
+			++ip;
+			continue;
+		}
+
+		std::size_t len = MIN_MATCH;
+		while (ip + len + TAIL_LITERALS < size && src[ref + len] == src[ip + len])
+			++len;
+
+		putSequence(out, src + anchor, ip - anchor, ip - ref, len);
+		ip += len;
+		anchor = ip;
+	}
+
+	putLiterals(out, src + anchor, size - anchor);
+}
+
+/**
+ * @brief Decompresses a block created by compress() and appends it to @p out.
+ * @return `false` if the block is corrupt.
+ */
+bool decompress(const char *src, std::size_t size, std::string &out)
+{
+	const unsigned char *ip = reinterpret_cast<const unsigned char*>(src);
+	const unsigned char *end = ip + size;
+	const std::size_t base = out.size();
+
+	while (ip < end) {
+		unsigned char token = *ip++;
+
+		std::size_t litLen = token >> 4;
+		if (litLen == 15 && !getLength(ip, end, litLen))
+			return false;
+		if (static_cast<std::size_t>(end - ip) < litLen)
+			return false;
+		out.append(reinterpret_cast<const char*>(ip), litLen);
+		ip += litLen;
+
+		if (ip == end)
+			break;
+
+		if (end - ip < 2)
+			return false;
+		std::size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		std::size_t matchLen = token & 15;
+		if (matchLen == 15 && !getLength(ip, end, matchLen))
+			return false;
+		matchLen += MIN_MATCH;
+		if (offset == 0 || offset > out.size() - base)
+			return false;
+
+		// The match may overlap with the output, so copy byte by byte
+		std::size_t pos = out.size();
+		out.resize(pos + matchLen);
+		char *dest = &out[pos];
+		const char *from = dest - offset;
+		for (std::size_t i = 0; i < matchLen; ++i)
+			dest[i] = from[i];
+	}
+	return true;
+}
+
+void BlockHeader::write(char *dest) const
+{
+	std::memcpy(dest, MAGIC, sizeof(MAGIC));
+	dest[3] = compressed ? 1 : 0;
+	for (int i = 0; i < 4; ++i) {
+		dest[4 + i] = static_cast<char>(rawSize >> (8 * i));
+		dest[8 + i] = static_cast<char>(storedSize >> (8 * i));
+	}
+}
+
+bool BlockHeader::read(const char *src)
+{
+	if (std::memcmp(src, MAGIC, sizeof(MAGIC)) != 0 || (src[3] & ~1) != 0)
+		return false;
+	compressed = src[3] != 0;
+	rawSize = storedSize = 0;
+	for (int i = 0; i < 4; ++i) {
+		rawSize |= std::uint32_t(static_cast<unsigned char>(src[4 + i])) << (8 * i);
+		storedSize |= std::uint32_t(static_cast<unsigned char>(src[8 + i])) << (8 * i);
+	}
+	return true;
+}
+
+} // namespace lz
+} // namespace log
+} // namespace utl
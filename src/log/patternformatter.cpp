@@ -0,0 +1,321 @@
+#include "utl/log/patternformatter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using std::string;
+
+namespace {
+
+struct ThreadCacheEntry {
+	std::uint64_t formatter;
+	int level;
+	string loggerName;
+	std::shared_ptr<const std::vector<string>> prefixes;
+};
+
+// The prefixes the current thread used last, the most recent first
+thread_local std::vector<ThreadCacheEntry> threadCache;
+
+std::atomic<std::uint64_t> nextId(1);
+
+} // namespace
+
+static void appendMessage(string &out, const string &message);
+static void appendDate(string &out, const string &format);
+static void appendNumber(string &out, unsigned long long value);
+
+
+namespace utl {
+namespace log {
+
+const char *const PatternFormatter::DEFAULT_PATTERN = "[%l][%n]%X %m";
+const std::size_t PatternFormatter::MAX_CACHED_LOGGERS;
+const std::size_t PatternFormatter::MAX_THREAD_CACHED_PREFIXES;
+
+/**
+ * @brief Compiles @p pattern.
+ *
+ * @param pattern The layout, see the description of the class.
+ * @param colors Whether the level and the logger name are highlighted with
+ *        ANSI escape sequences.
+ * @throw std::invalid_argument If the pattern contains an unknown or
+ *        incomplete conversion.
+ */
+PatternFormatter::PatternFormatter(const string &pattern, bool colors) :
+	mId(nextId.fetch_add(1)),
+	mPattern(pattern),
+	mColors(colors)
+{
+	Run run;
+	auto addText = [&run](const string &text) {
+		if (!run.empty() && run.back().first == Part::TEXT)
+			run.back().second += text;
+		else
+			run.emplace_back(Part::TEXT, text);
+	};
+	auto addStep = [this, &run](Op op, const string &argument) {
+		if (!run.empty()) {
+			mSteps.push_back(Step{Op::PREFIX, mRuns.size(), string()});
+			mRuns.push_back(std::move(run));
+			run.clear();
+		}
+		mSteps.push_back(Step{op, 0, argument});
+	};
+
+	for (std::size_t i = 0; i < pattern.size(); ++i) {
+		if (pattern[i] != '%') {
+			std::size_t end = std::min(pattern.find('%', i), pattern.size());
+			addText(pattern.substr(i, end - i));
+			i = end - 1;
+			continue;
+		}
+		if (++i == pattern.size())
+			throw std::invalid_argument("Incomplete conversion at the end of the pattern");
+
+		switch (pattern[i]) {
+		case '%': addText("%"); break;
+		case 'l': run.emplace_back(Part::LEVEL, string()); break;
+		case 'n': run.emplace_back(Part::NAME, string()); break;
+		case 'm': addStep(Op::MESSAGE, string()); break;
+		case 'X': addStep(Op::CONTEXT, string()); break;
+		case 't': addStep(Op::THREAD, string()); break;
+		case 'F': addStep(Op::FILE, string()); break;
+		case 'L': addStep(Op::LINE, string()); break;
+		case 'M': addStep(Op::FUNCTION, string()); break;
+		case 'd': {
+			string format;
+			if (i + 1 < pattern.size() && pattern[i + 1] == '{') {
+				std::size_t end = pattern.find('}', i + 2);
+				if (end == string::npos)
+					throw std::invalid_argument("Missing '}' after %d{");
+				format = pattern.substr(i + 2, end - i - 2);
+				if (format == "ISO8601")
+					format.clear();
+				i = end;
+			}
+			addStep(Op::DATE, format);
+			break;
+		}
+		default:
+			throw std::invalid_argument(string("Unknown conversion %") + pattern[i]);
+		}
+	}
+	if (!run.empty()) {
+		mSteps.push_back(Step{Op::PREFIX, mRuns.size(), string()});
+		mRuns.push_back(std::move(run));
+	}
+}
+
+/**
+ * @brief Appends the formatted @p record to @p out.
+ *
+ * No line break is appended. Reusing @p out for several records avoids
+ * allocations.
+ */
+void PatternFormatter::format(const LogRecord &record, string &out) const
+{
+	const Prefixes *prefixes = nullptr;
+	if (!mRuns.empty())
+		prefixes = &this->prefixes(record);
+
+	for (const Step &step : mSteps) {
+		switch (step.op) {
+		case Op::PREFIX:
+			out += (*prefixes)[step.index];
+			break;
+		case Op::MESSAGE:
+			appendMessage(out, record.message);
+			break;
+		case Op::CONTEXT:
+			if (!record.context.empty()) {
+				out += '[';
+				out += record.context;
+				out += ']';
+			}
+			break;
+		case Op::DATE:
+			appendDate(out, step.argument);
+			break;
+		case Op::THREAD:
+			appendNumber(out, std::hash<std::thread::id>()(std::this_thread::get_id()));
+			break;
+		case Op::FILE:
+			out += record.site ? record.site->file : "?";
+			break;
+		case Op::LINE:
+			if (record.site)
+				appendNumber(out, static_cast<unsigned long long>(record.site->line));
+			else
+				out += '?';
+			break;
+		case Op::FUNCTION:
+			out += record.site ? record.site->function : "?";
+			break;
+		}
+	}
+
+	if (record.stackTrace && !record.stackTrace->empty()) {
+		string trace(1, '\n');
+		record.stackTrace->appendTo(trace);
+		appendMessage(out, trace);
+	}
+}
+
+/**
+ * @brief Returns the rendered text of all runs for the logger and the level
+ * of @p record.
+ *
+ * The prefixes are taken from the cache of the current thread, which needs
+ * no lock. The reference is valid until the next call in this thread.
+ */
+const PatternFormatter::Prefixes &PatternFormatter::prefixes(const LogRecord &record) const
+{
+	int level = static_cast<int>(record.level);
+	std::vector<ThreadCacheEntry> &cache = threadCache;
+	for (auto it = cache.begin(); it != cache.end(); ++it) {
+		if (it->formatter == mId && it->level == level && it->loggerName == record.loggerName) {
+			std::rotate(cache.begin(), it, it + 1);
+			return *cache.front().prefixes;
+		}
+	}
+
+	std::shared_ptr<const Prefixes> prefixes = lookup(record);
+	if (cache.size() < MAX_THREAD_CACHED_PREFIXES)
+		cache.emplace_back();
+	std::rotate(cache.begin(), cache.end() - 1, cache.end());
+	ThreadCacheEntry &entry = cache.front();
+	entry.formatter = mId;
+	entry.level = level;
+	entry.loggerName = record.loggerName;
+	entry.prefixes = std::move(prefixes);
+	return *entry.prefixes;
+}
+
+/**
+ * @brief Returns the prefixes from the cache of the formatter, they are
+ * rendered if necessary.
+ */
+std::shared_ptr<const PatternFormatter::Prefixes> PatternFormatter::lookup(
+		const LogRecord &record) const
+{
+	int level = static_cast<int>(record.level);
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mCache.find(record.loggerName);
+	if (it == mCache.end()) {
+		// Many loggers would make the cache grow without bound
+		if (mCache.size() >= MAX_CACHED_LOGGERS) {
+			mCache.erase(mRecent.back().loggerName);
+			mRecent.pop_back();
+		}
+		mRecent.push_front(CacheEntry{record.loggerName, {}});
+		it = mCache.emplace(record.loggerName, mRecent.begin()).first;
+	} else {
+		mRecent.splice(mRecent.begin(), mRecent, it->second);
+		for (const auto &entry : it->second->levels) {
+			if (entry.first == level)
+				return entry.second;
+		}
+	}
+
+	string colorLevel, colorLogger, colorEnd;
+	if (mColors) {
+		colorEnd = "\x1b[0m";
+		colorLogger = "\x1b[1m";
+		if (record.level <= LogLevel::INFO)
+			colorLevel = "\x1b[32m";
+		else if (record.level <= LogLevel::WARNING)
+			colorLevel = "\x1b[33m";
+		else
+			colorLevel = "\x1b[31m";
+	}
+
+	auto prefixes = std::make_shared<Prefixes>();
+	for (const Run &run : mRuns) {
+		std::ostringstream text;
+		for (const auto &part : run) {
+			switch (part.first) {
+			case Part::TEXT:
+				text << part.second;
+				break;
+			case Part::LEVEL:
+				text << colorLevel << record.level << colorEnd;
+				break;
+			case Part::NAME:
+				text << colorLogger << record.loggerName << colorEnd;
+				break;
+			}
+		}
+		prefixes->push_back(text.str());
+	}
+	it->second->levels.emplace_back(level, prefixes);
+	return prefixes;
+}
+
+} // namespace log
+} // namespace utl
+
+
+/**
+ * Appends the message and indents all lines after the first.
+ */
+void appendMessage(string &out, const string &message)
+{
+	string::size_type lineStart = 0, lineEnd;
+	while ((lineEnd = message.find('\n', lineStart)) != string::npos) {
+		out.append(message, lineStart, lineEnd - lineStart);
+		out += "\n    ";
+		lineStart = lineEnd + 1;
+	}
+	out.append(message, lineStart, string::npos);
+}
+
+/**
+ * Appends the current local time. An empty format selects ISO 8601 with
+ * milliseconds. The text of the current second is cached per thread.
+ */
+void appendDate(string &out, const string &format)
+{
+	using namespace std::chrono;
+	system_clock::time_point now = system_clock::now();
+	std::time_t seconds = system_clock::to_time_t(now);
+
+	thread_local std::time_t cachedSeconds = -1;
+	thread_local string cachedFormat;
+	thread_local char cachedText[128];
+	thread_local std::size_t cachedLength = 0;
+	if (seconds != cachedSeconds || format != cachedFormat) {
+		std::tm local;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+		localtime_s(&local, &seconds);
+#else
+		localtime_r(&seconds, &local);
+#endif
+		cachedLength = std::strftime(cachedText, sizeof(cachedText),
+				format.empty() ? "%Y-%m-%dT%H:%M:%S" : format.c_str(), &local);
+		cachedSeconds = seconds;
+		cachedFormat = format;
+	}
+	out.append(cachedText, cachedLength);
+
+	if (format.empty()) {
+		long long millis = duration_cast<milliseconds>(now.time_since_epoch()).count() % 1000;
+		char text[8];
+		std::snprintf(text, sizeof(text), ".%03lld", millis < 0 ? millis + 1000 : millis);
+		out += text;
+	}
+}
+
+void appendNumber(string &out, unsigned long long value)
+{
+	char text[24];
+	int length = std::snprintf(text, sizeof(text), "%llu", value);
+	out.append(text, static_cast<std::size_t>(length));
+}
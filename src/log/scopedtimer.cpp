@@ -0,0 +1,84 @@
+#include "utl/log/scopedtimer.h"
+
+#include <functional>
+#include <thread>
+
+#include "utl/utils.h"
+
+static void writeJsonString(std::ostream &stream, const char *str)
+{
+	stream << '"';
+	for (; *str != '\0'; ++str) {
+		char c = *str;
+		if (c == '"' || c == '\\')
+			stream << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+			stream << utl::format("\\u%04x", c);
+		else
+			stream << c;
+	}
+	stream << '"';
+}
+
+
+namespace utl {
+namespace log {
+
+void TraceRecorder::record(const char *name, Clock::time_point start, Clock::duration duration)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	Span span;
+	span.name = name;
+	span.start = duration_cast<microseconds>(start - mEpoch).count();
+	span.duration = duration_cast<microseconds>(duration).count();
+	span.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSpans.push_back(span);
+}
+
+/**
+ * @brief Writes all spans as JSON in the Chrome trace event format.
+ *
+ * Every span is written as complete event (`"ph":"X"`). The timestamps are
+ * relative to the construction of the recorder.
+ */
+void TraceRecorder::writeJson(std::ostream &stream) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	stream << "{\"traceEvents\":[";
+	for (std::size_t i = 0; i < mSpans.size(); ++i) {
+		const Span &span = mSpans[i];
+		stream << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+		writeJsonString(stream, span.name);
+		stream << ",\"ph\":\"X\",\"ts\":" << span.start
+		       << ",\"dur\":" << span.duration
+		       << ",\"pid\":0,\"tid\":" << span.thread << "}";
+	}
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+/**
+ * @brief Stops the timer before the end of the scope.
+ *
+ * The elapsed time is logged (and recorded) at most once.
+ */
+void ScopedTimer::stop()
+{
+	if (!mLogger)
+		return;
+
+	Clock::duration duration = Clock::now() - mStart;
+	if (mTrace)
+		mTrace->record(mName, mStart, duration);
+	if (duration >= mThreshold) {
+		double ms = std::chrono::duration<double, std::milli>(duration).count();
+		mLogger->log(mLevel, "%s took %.3f ms", mName, ms);
+	}
+	mLogger = nullptr;
+}
+
+} // namespace log
+} // namespace utl
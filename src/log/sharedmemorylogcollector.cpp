@@ -0,0 +1,111 @@
+#include "utl/log/sharedmemorylogcollector.h"
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <dirent.h>
+#include <unistd.h>
+
+
+namespace utl {
+namespace log {
+
+SharedMemoryLogCollector::SharedMemoryLogCollector(const std::string &directory,
+		std::chrono::milliseconds delay) :
+	mDirectory(directory),
+	mDelay(delay)
+{
+}
+
+/**
+ * @brief Appends the new records to @p records, ordered by time.
+ *
+ * Records younger than the delay are kept for the next call.
+ *
+ * @return The number of records appended.
+ */
+std::size_t SharedMemoryLogCollector::collect(std::vector<Record> &records)
+{
+	return collect(records, false);
+}
+
+/**
+ * @brief Like collect(), but ignores the delay. Used before the collector
+ * stops.
+ */
+std::size_t SharedMemoryLogCollector::collectAll(std::vector<Record> &records)
+{
+	return collect(records, true);
+}
+
+std::size_t SharedMemoryLogCollector::collect(std::vector<Record> &records, bool all)
+{
+	scan();
+
+	std::size_t pending = mPending.size();
+	for (auto it = mRings.begin(); it != mRings.end(); ) {
+		SharedMemoryRing &ring = *it->second;
+		ring.read(mPending);
+		if (ring.empty() && !ring.isProducerAlive()) {
+			::unlink(ring.getPath().c_str());
+			it = mRings.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Sort the new records and merge them with the held back ones
+	if (pending != mPending.size()) {
+		auto byTime = [](const Record &a, const Record &b) { return a.time < b.time; };
+		std::stable_sort(mPending.begin() + static_cast<std::ptrdiff_t>(pending),
+				mPending.end(), byTime);
+		std::inplace_merge(mPending.begin(),
+				mPending.begin() + static_cast<std::ptrdiff_t>(pending), mPending.end(), byTime);
+	}
+
+	std::size_t count = mPending.size();
+	if (!all && mDelay.count() > 0) {
+		std::int64_t limit = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				(std::chrono::system_clock::now() - mDelay).time_since_epoch()).count();
+		count = static_cast<std::size_t>(std::upper_bound(mPending.begin(), mPending.end(),
+				limit, [](std::int64_t time, const Record &r) { return time < r.time; })
+				- mPending.begin());
+	}
+
+	records.reserve(records.size() + count);
+	std::move(mPending.begin(), mPending.begin() + static_cast<std::ptrdiff_t>(count),
+			std::back_inserter(records));
+	mPending.erase(mPending.begin(), mPending.begin() + static_cast<std::ptrdiff_t>(count));
+	return count;
+}
+
+/**
+ * Opens all rings in the directory which are not open yet.
+ */
+void SharedMemoryLogCollector::scan()
+{
+	DIR *dir = ::opendir(mDirectory.c_str());
+	if (dir == nullptr)
+		return;
+	while (dirent *entry = ::readdir(dir)) {
+		std::size_t length = std::strlen(entry->d_name);
+		if (length < 5 || std::strcmp(entry->d_name + length - 5, ".ring") != 0)
+			continue;
+		std::string path = mDirectory + "/" + entry->d_name;
+		if (mRings.count(path))
+			continue;
+		std::unique_ptr<SharedMemoryRing> ring(new SharedMemoryRing(path));
+		// A ring which is not valid yet is tried again in the next scan
+		if (ring->good())
+			mRings.emplace(path, std::move(ring));
+	}
+	::closedir(dir);
+}
+
+} // namespace log
+} // namespace utl
+
+#endif
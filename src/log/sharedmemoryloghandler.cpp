@@ -0,0 +1,56 @@
+#include "utl/log/sharedmemoryloghandler.h"
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+
+#include <atomic>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string ringPath(const std::string &directory);
+
+
+namespace utl {
+namespace log {
+
+/**
+ * @brief Creates a ring of @p capacity bytes in @p directory.
+ *
+ * The directory is created if it does not exist.
+ */
+SharedMemoryLogHandler::SharedMemoryLogHandler(const std::string &directory,
+		std::size_t capacity) :
+	mRing(ringPath(directory), capacity)
+{
+}
+
+/**
+ * @brief Marks the ring as closed, so the collector removes it once it is
+ * empty.
+ */
+SharedMemoryLogHandler::~SharedMemoryLogHandler()
+{
+	mRing.close();
+}
+
+void SharedMemoryLogHandler::publish(const LogRecord &record)
+{
+	mRing.write(record);
+}
+
+} // namespace log
+} // namespace utl
+
+
+/**
+ * Returns a path for a new ring, which is unique for the process.
+ */
+std::string ringPath(const std::string &directory)
+{
+	static std::atomic<unsigned int> counter(0);
+	::mkdir(directory.c_str(), 0700);
+	return directory + "/" + std::to_string(::getpid()) + "-" +
+			std::to_string(counter.fetch_add(1)) + ".ring";
+}
+
+#endif
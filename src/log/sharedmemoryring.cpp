@@ -0,0 +1,341 @@
+#include "utl/log/sharedmemoryring.h"
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+		"The ring needs lock-free atomics to be shared between processes");
+
+static std::size_t align(std::size_t size);
+
+// State of a slot which can be read, free slots are zero
+static const std::uint32_t COMMITTED = 1;
+
+/**
+ * The fixed part of a record. It is preceded by the size and the state of
+ * the slot, which are accessed atomically.
+ */
+struct Fields {
+	std::int64_t time;
+	std::int32_t level;
+	std::uint32_t nameLength;
+	std::uint32_t messageLength;
+	std::uint32_t contextLength;
+};
+
+static const std::size_t SLOT_HEADER = 8;
+static const std::size_t ALIGNMENT = 8;
+
+
+namespace utl {
+namespace log {
+
+/**
+ * The header at the beginning of the file. Positions count bytes since the
+ * creation of the ring, the offset in the data area is the position modulo
+ * the capacity.
+ */
+struct SharedMemoryRing::Header {
+	std::atomic<std::uint32_t> magic;
+	std::uint32_t version;
+	std::uint64_t capacity;
+	std::int32_t pid;
+	std::atomic<std::uint32_t> closed;
+	// the end of the space reserved by producers
+	std::atomic<std::uint64_t> reserved;
+	// the end of the records read by the collector
+	std::atomic<std::uint64_t> consumed;
+	std::atomic<std::uint64_t> dropped;
+	char padding[16];
+};
+
+/**
+ * @brief Creates the file @p path with a ring of @p capacity bytes for the
+ * current process.
+ *
+ * An existing file is replaced. Use good() to check for errors.
+ */
+SharedMemoryRing::SharedMemoryRing(const std::string &path, std::size_t capacity) :
+	mPath(path),
+	mMemory(nullptr),
+	mSize(0),
+	mHeader(nullptr),
+	mData(nullptr),
+	mCapacity(align(std::max<std::size_t>(capacity, 4096)))
+{
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd < 0)
+		return;
+	std::size_t size = sizeof(Header) + mCapacity;
+	if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+		void *memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (memory != MAP_FAILED) {
+			mMemory = memory;
+			mSize = size;
+		}
+	}
+	::close(fd);
+	if (mMemory == nullptr)
+		return;
+
+	mHeader = new (mMemory) Header();
+	mHeader->version = VERSION;
+	mHeader->capacity = mCapacity;
+	mHeader->pid = static_cast<std::int32_t>(::getpid());
+	mData = static_cast<char*>(mMemory) + sizeof(Header);
+	// A collector only opens the ring after the magic number is written
+	mHeader->magic.store(MAGIC, std::memory_order_release);
+}
+
+/**
+ * @brief Opens the ring in the file @p path, which was created by another
+ * process.
+ *
+ * Use good() to check whether the file contains a valid ring.
+ */
+SharedMemoryRing::SharedMemoryRing(const std::string &path) :
+	mPath(path),
+	mMemory(nullptr),
+	mSize(0),
+	mHeader(nullptr),
+	mData(nullptr),
+	mCapacity(0)
+{
+	int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+	if (fd < 0)
+		return;
+	struct stat info;
+	if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) > sizeof(Header)) {
+		std::size_t size = static_cast<std::size_t>(info.st_size);
+		void *memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (memory != MAP_FAILED) {
+			mMemory = memory;
+			mSize = size;
+		}
+	}
+	::close(fd);
+	if (mMemory == nullptr)
+		return;
+
+	Header *header = static_cast<Header*>(mMemory);
+	if (header->magic.load(std::memory_order_acquire) != MAGIC ||
+			header->version != VERSION ||
+			header->capacity != mSize - sizeof(Header) ||
+			header->capacity % ALIGNMENT != 0)
+		return;
+	mHeader = header;
+	mData = static_cast<char*>(mMemory) + sizeof(Header);
+	mCapacity = static_cast<std::size_t>(header->capacity);
+}
+
+/**
+ * @brief Unmaps the ring. The file is kept.
+ */
+SharedMemoryRing::~SharedMemoryRing()
+{
+	if (mMemory != nullptr)
+		::munmap(mMemory, mSize);
+}
+
+int SharedMemoryRing::getPid() const
+{
+	return mHeader ? mHeader->pid : 0;
+}
+
+std::size_t SharedMemoryRing::getDroppedRecords() const
+{
+	return mHeader ? static_cast<std::size_t>(mHeader->dropped.load(std::memory_order_relaxed)) : 0;
+}
+
+/**
+ * @brief Writes a record into the ring.
+ *
+ * The message is truncated to a quarter of the capacity.
+ *
+ * @return `true` if the record was written, `false` if it was dropped
+ *         because the ring is full.
+ */
+bool SharedMemoryRing::write(const LogRecord &record)
+{
+	if (mHeader == nullptr)
+		return false;
+
+	std::size_t maxText = mCapacity / 4;
+	Fields fields;
+	fields.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	fields.level = static_cast<int>(record.level);
+	fields.nameLength = static_cast<std::uint32_t>(std::min(record.loggerName.size(), maxText));
+	fields.contextLength = static_cast<std::uint32_t>(std::min(record.context.size(), maxText));
+	fields.messageLength = static_cast<std::uint32_t>(std::min(record.message.size(), maxText));
+	std::size_t size = align(SLOT_HEADER + sizeof(Fields) + fields.nameLength +
+			fields.messageLength + fields.contextLength);
+
+	// Reserve the space
+	std::uint64_t pos = mHeader->reserved.load(std::memory_order_relaxed);
+	do {
+		std::uint64_t consumed = mHeader->consumed.load(std::memory_order_acquire);
+		if (pos + size - consumed > mCapacity) {
+			mHeader->dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	} while (!mHeader->reserved.compare_exchange_weak(pos, pos + size,
+			std::memory_order_acq_rel, std::memory_order_relaxed));
+
+	char *slot = mData + pos % mCapacity;
+	reinterpret_cast<std::atomic<std::uint32_t>*>(slot)->store(
+			static_cast<std::uint32_t>(size), std::memory_order_relaxed);
+	std::uint64_t at = pos + SLOT_HEADER;
+	copyIn(at, &fields, sizeof(fields));
+	at += sizeof(fields);
+	copyIn(at, record.loggerName.data(), fields.nameLength);
+	at += fields.nameLength;
+	copyIn(at, record.message.data(), fields.messageLength);
+	at += fields.messageLength;
+	copyIn(at, record.context.data(), fields.contextLength);
+	reinterpret_cast<std::atomic<std::uint32_t>*>(slot + 4)->store(
+			COMMITTED, std::memory_order_release);
+	return true;
+}
+
+/**
+ * @brief Takes all committed records out of the ring and appends them to
+ * @p records.
+ *
+ * The records are read in the order of their reservation. Reading stops at
+ * the first record which is not committed yet, unless the producer does not
+ * exist anymore. Only one process may read from a ring.
+ *
+ * @return The number of records read.
+ */
+std::size_t SharedMemoryRing::read(std::vector<Record> &records)
+{
+	if (mHeader == nullptr)
+		return 0;
+
+	std::size_t count = 0;
+	std::uint64_t pos = mHeader->consumed.load(std::memory_order_relaxed);
+	std::uint64_t end = mHeader->reserved.load(std::memory_order_acquire);
+	bool alive = true;
+	while (pos < end) {
+		char *slot = mData + pos % mCapacity;
+		std::uint32_t state = reinterpret_cast<std::atomic<std::uint32_t>*>(slot + 4)->load(
+				std::memory_order_acquire);
+		std::uint32_t size = reinterpret_cast<std::atomic<std::uint32_t>*>(slot)->load(
+				std::memory_order_relaxed);
+		if (state != COMMITTED) {
+			if (alive)
+				alive = isProducerAlive();
+			if (alive)
+				break;
+			// Skip the record of the crashed producer, or everything if
+			// not even the size was written
+			if (size == 0 || size % ALIGNMENT != 0 || size > end - pos)
+				size = static_cast<std::uint32_t>(end - pos);
+			clear(pos, size);
+			pos += size;
+			continue;
+		}
+
+		Fields fields;
+		copyOut(pos + SLOT_HEADER, &fields, sizeof(fields));
+		records.emplace_back();
+		Record &out = records.back();
+		out.time = fields.time;
+		out.pid = mHeader->pid;
+		out.record.level = LogLevel(fields.level);
+		std::uint64_t at = pos + SLOT_HEADER + sizeof(fields);
+		out.record.loggerName.resize(fields.nameLength);
+		copyOut(at, &out.record.loggerName[0], fields.nameLength);
+		at += fields.nameLength;
+		out.record.message.resize(fields.messageLength);
+		copyOut(at, &out.record.message[0], fields.messageLength);
+		at += fields.messageLength;
+		out.record.context.resize(fields.contextLength);
+		copyOut(at, &out.record.context[0], fields.contextLength);
+
+		// Producers expect free slots to be zeroed
+		clear(pos, size);
+		pos += size;
+		++count;
+	}
+	mHeader->consumed.store(pos, std::memory_order_release);
+	return count;
+}
+
+/**
+ * @brief Marks that the producer will not write any more records.
+ */
+void SharedMemoryRing::close()
+{
+	if (mHeader)
+		mHeader->closed.store(1, std::memory_order_release);
+}
+
+bool SharedMemoryRing::isClosed() const
+{
+	return mHeader && mHeader->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool SharedMemoryRing::isProducerAlive() const
+{
+	if (mHeader == nullptr || isClosed())
+		return false;
+	return ::kill(mHeader->pid, 0) == 0 || errno == EPERM;
+}
+
+bool SharedMemoryRing::empty() const
+{
+	return mHeader == nullptr || mHeader->consumed.load(std::memory_order_acquire) ==
+			mHeader->reserved.load(std::memory_order_acquire);
+}
+
+void SharedMemoryRing::copyIn(std::uint64_t pos, const void *src, std::size_t size)
+{
+	std::size_t offset = static_cast<std::size_t>(pos % mCapacity);
+	std::size_t first = std::min(size, mCapacity - offset);
+	std::memcpy(mData + offset, src, first);
+	std::memcpy(mData, static_cast<const char*>(src) + first, size - first);
+}
+
+void SharedMemoryRing::copyOut(std::uint64_t pos, void *dst, std::size_t size) const
+{
+	std::size_t offset = static_cast<std::size_t>(pos % mCapacity);
+	std::size_t first = std::min(size, mCapacity - offset);
+	std::memcpy(dst, mData + offset, first);
+	std::memcpy(static_cast<char*>(dst) + first, mData, size - first);
+}
+
+void SharedMemoryRing::clear(std::uint64_t pos, std::size_t size)
+{
+	std::size_t offset = static_cast<std::size_t>(pos % mCapacity);
+	std::size_t first = std::min(size, mCapacity - offset);
+	std::memset(mData + offset, 0, first);
+	std::memset(mData, 0, size - first);
+}
+
+} // namespace log
+} // namespace utl
+
+
+/**
+ * Rounds @p size up to a multiple of the alignment of the slots.
+ */
+std::size_t align(std::size_t size)
+{
+	return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+#endif
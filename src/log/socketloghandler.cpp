@@ -0,0 +1,315 @@
+#include "utl/log/socketloghandler.h"
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "utl/log/logrecord.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Upper bound of buffers passed to a single sendmsg/sendmmsg call
+static const std::size_t MAX_IOV = 64;
+
+
+namespace utl {
+namespace log {
+
+SocketLogHandler::SocketLogHandler(const std::string &path, Type type,
+		const std::string &pattern) :
+	mPath(path),
+	mType(type),
+	mFormatter(pattern),
+	mSocket(-1),
+	mBatchSize(32),
+	mBufferLimit(1024 * 1024),
+	mFlushLevel(LogLevel::WARNING),
+	mPendingBytes(0),
+	mOffset(0),
+	mDropped(0)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	connect();
+}
+
+SocketLogHandler::~SocketLogHandler()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mSocket >= 0 || connect())
+		send();
+	disconnect();
+}
+
+std::size_t SocketLogHandler::getBatchSize() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBatchSize;
+}
+
+void SocketLogHandler::setBatchSize(std::size_t records)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBatchSize = std::max<std::size_t>(records, 1);
+}
+
+std::size_t SocketLogHandler::getBufferLimit() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBufferLimit;
+}
+
+void SocketLogHandler::setBufferLimit(std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBufferLimit = bytes;
+}
+
+const LogLevel &SocketLogHandler::getFlushLevel() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mFlushLevel;
+}
+
+void SocketLogHandler::setFlushLevel(const LogLevel &level)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFlushLevel = level;
+}
+
+bool SocketLogHandler::isConnected() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mSocket >= 0;
+}
+
+std::size_t SocketLogHandler::getPendingRecords() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mPending.size();
+}
+
+std::size_t SocketLogHandler::getDroppedRecords() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mDropped;
+}
+
+/**
+ * @brief Sends all pending records.
+ *
+ * Connects to the collector first if there is no connection.
+ *
+ * @return `true` if the queue is empty afterwards, `false` otherwise.
+ */
+bool SocketLogHandler::flush()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mSocket < 0 && !connect())
+		return mPending.empty();
+	return send();
+}
+
+void SocketLogHandler::publish(const LogRecord &record)
+{
+	std::string line = format(record);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	enqueue(std::move(line));
+
+	if (mPending.size() >= mBatchSize || record.level >= mFlushLevel) {
+		if (mSocket >= 0 || connect())
+			send();
+	}
+}
+
+void SocketLogHandler::publishBatch(const LogRecord *records, std::size_t count)
+{
+	std::vector<std::string> lines;
+	lines.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+		lines.push_back(format(records[i]));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	bool urgent = false;
+	for (std::size_t i = 0; i < count; ++i) {
+		enqueue(std::move(lines[i]));
+		urgent = urgent || records[i].level >= mFlushLevel;
+	}
+
+	if (mPending.size() >= mBatchSize || urgent) {
+		if (mSocket >= 0 || connect())
+			send();
+	}
+}
+
+std::string SocketLogHandler::format(const LogRecord &record) const
+{
+	std::string line;
+	mFormatter.format(record, line);
+	line += '\n';
+	return line;
+}
+
+bool SocketLogHandler::connect()
+{
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (mPath.size() >= sizeof(addr.sun_path))
+		return false;
+	std::memcpy(addr.sun_path, mPath.c_str(), mPath.size() + 1);
+
+	int fd = ::socket(AF_UNIX, mType == Type::STREAM ? SOCK_STREAM : SOCK_DGRAM, 0);
+	if (fd < 0)
+		return false;
+	::fcntl(fd, F_SETFD, FD_CLOEXEC);
+	::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	mSocket = fd;
+	// A partially written record is sent again over the new connection
+	mOffset = 0;
+	return true;
+}
+
+void SocketLogHandler::disconnect()
+{
+	if (mSocket >= 0) {
+		::close(mSocket);
+		mSocket = -1;
+	}
+}
+
+bool SocketLogHandler::send()
+{
+	bool ok = (mType == Type::STREAM) ? sendStream() : sendDatagram();
+	return ok && mPending.empty();
+}
+
+bool SocketLogHandler::sendStream()
+{
+	while (!mPending.empty()) {
+		iovec iov[MAX_IOV];
+		std::size_t n = std::min(mPending.size(), MAX_IOV);
+		for (std::size_t i = 0; i < n; ++i) {
+			std::size_t offset = (i == 0) ? mOffset : 0;
+			iov[i].iov_base = const_cast<char*>(mPending[i].data() + offset);
+			iov[i].iov_len = mPending[i].size() - offset;
+		}
+
+		msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = n;
+
+		ssize_t written = ::sendmsg(mSocket, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				disconnect();
+			return false;
+		}
+
+		// Remove everything which has been written completely
+		std::size_t remaining = written;
+		std::size_t done = 0;
+		while (done < n && remaining >= iov[done].iov_len)
+			remaining -= iov[done++].iov_len;
+		consume(done);
+		mOffset += remaining;
+	}
+	return true;
+}
+
+bool SocketLogHandler::sendDatagram()
+{
+	while (!mPending.empty()) {
+		std::size_t n = std::min(mPending.size(), MAX_IOV);
+		std::size_t sent = 0;
+#if defined(__linux__)
+		iovec iov[MAX_IOV];
+		mmsghdr msgs[MAX_IOV];
+		std::memset(msgs, 0, sizeof(msgs));
+		for (std::size_t i = 0; i < n; ++i) {
+			iov[i].iov_base = const_cast<char*>(mPending[i].data());
+			iov[i].iov_len = mPending[i].size();
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		int result = ::sendmmsg(mSocket, msgs, n, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (result > 0)
+			sent = result;
+#else
+		while (sent < n && ::send(mSocket, mPending[sent].data(),
+				mPending[sent].size(), MSG_NOSIGNAL | MSG_DONTWAIT) >= 0)
+			++sent;
+#endif
+		if (sent > 0) {
+			consume(sent);
+			continue;
+		}
+		if (errno == EINTR)
+			continue;
+		if (errno == EMSGSIZE) {
+			// The record can never be sent, but the connection is fine
+			mPendingBytes -= mPending.front().size();
+			mPending.pop_front();
+			++mDropped;
+			continue;
+		}
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS)
+			disconnect();
+		return false;
+	}
+	return true;
+}
+
+void SocketLogHandler::consume(std::size_t records)
+{
+	for (std::size_t i = 0; i < records; ++i) {
+		mPendingBytes -= mPending.front().size();
+		mPending.pop_front();
+	}
+	if (records > 0)
+		mOffset = 0;
+}
+
+/**
+ * Appends a line to the queue. The mutex has to be locked.
+ */
+void SocketLogHandler::enqueue(std::string line)
+{
+	mPendingBytes += line.size();
+	mPending.push_back(std::move(line));
+
+	// Drop the oldest records if the buffer is full. A partially written
+	// record has to stay since the stream would be corrupted otherwise.
+	std::size_t keep = (mOffset > 0) ? 1 : 0;
+	while (mPendingBytes > mBufferLimit && mPending.size() > keep + 1) {
+		auto it = mPending.begin() + keep;
+		mPendingBytes -= it->size();
+		mPending.erase(it);
+		++mDropped;
+	}
+}
+
+} // namespace log
+} // namespace utl
+
+#endif
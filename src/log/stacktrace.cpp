@@ -0,0 +1,100 @@
+#include "utl/log/stacktrace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define UTL_HAS_BACKTRACE
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+static void appendFrame(std::string &str, std::size_t index, void *address);
+
+
+namespace utl {
+namespace log {
+
+const std::size_t StackTrace::MAX_DEPTH;
+
+/**
+ * @brief Stores the return addresses of the current thread.
+ *
+ * The frame of capture() itself is never stored.
+ *
+ * @param skip The number of frames of the caller to skip.
+ * @param depth The maximum number of frames, at most #MAX_DEPTH.
+ */
+void StackTrace::capture(std::size_t skip, std::size_t depth) noexcept
+{
+	mSize = 0;
+#ifdef UTL_HAS_BACKTRACE
+	const std::size_t MAX_SKIP = 16;
+	void *frames[MAX_DEPTH + MAX_SKIP + 1];
+	skip = std::min(skip, MAX_SKIP) + 1;
+	depth = std::min(depth, MAX_DEPTH);
+	int count = ::backtrace(frames, static_cast<int>(skip + depth));
+	if (count > static_cast<int>(skip)) {
+		mSize = static_cast<std::size_t>(count) - skip;
+		std::copy(frames + skip, frames + skip + mSize, mFrames);
+	}
+#else
+	(void) skip;
+	(void) depth;
+#endif
+}
+
+/**
+ * @brief Appends one line per frame, without a line break after the last
+ * one.
+ *
+ * Names are looked up in the dynamic symbol tables of the loaded modules.
+ * Functions which are not exported are only written as offset into their
+ * module.
+ */
+void StackTrace::appendTo(std::string &str) const
+{
+	for (std::size_t i = 0; i < mSize; ++i) {
+		if (i != 0)
+			str += '\n';
+		appendFrame(str, i, mFrames[i]);
+	}
+}
+
+} // namespace log
+} // namespace utl
+
+
+/**
+ * Writes a frame like `#2 0x55d0c2a4f3b1 in main+0x41 (/usr/bin/server+0x23b1)`.
+ */
+void appendFrame(std::string &str, std::size_t index, void *address)
+{
+	char text[64];
+	std::snprintf(text, sizeof(text), "#%zu %p", index, address);
+	str += text;
+
+#ifdef UTL_HAS_BACKTRACE
+	Dl_info info;
+	if (::dladdr(address, &info) == 0 || info.dli_fname == nullptr)
+		return;
+	const char *base = static_cast<const char*>(info.dli_fbase);
+	if (info.dli_sname != nullptr && info.dli_saddr != nullptr) {
+		int status = -1;
+		char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		str += " in ";
+		str += (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+		std::free(demangled);
+		std::snprintf(text, sizeof(text), "+%#lx", static_cast<unsigned long>(
+				static_cast<const char*>(address) - static_cast<const char*>(info.dli_saddr)));
+		str += text;
+	}
+	str += " (";
+	str += info.dli_fname;
+	std::snprintf(text, sizeof(text), "+%#lx)",
+			static_cast<unsigned long>(static_cast<const char*>(address) - base));
+	str += text;
+#endif
+}
@@ -0,0 +1,178 @@
+#include "utl/optionindex.h"
+
+#include <algorithm>
+
+
+namespace utl {
+
+OptionIndex::OptionIndex() :
+	nodes(1)
+{
+}
+
+/**
+ * @brief Adds an option to the index or changes the key of an option.
+ */
+void OptionIndex::insert(const std::string &name, int key)
+{
+	std::uint32_t cur = 0;
+	std::size_t i = 0;
+	while (i < name.size()) {
+		std::uint32_t next = child(cur, name[i]);
+		if (next == 0) {
+			// There is no matching edge, add a leaf
+			Node leaf;
+			leaf.label = name.substr(i);
+			nodes.push_back(leaf);
+			next = static_cast<std::uint32_t>(nodes.size() - 1);
+			std::vector<std::uint32_t> &children = nodes[cur].children;
+			children.insert(std::upper_bound(children.begin(), children.end(), next,
+					[this](std::uint32_t a, std::uint32_t b) {
+						return nodes[a].label[0] < nodes[b].label[0];
+					}), next);
+			cur = next;
+			i = name.size();
+			break;
+		}
+
+		const std::string &label = nodes[next].label;
+		std::size_t common = 0;
+		while (common < label.size() && i + common < name.size() &&
+				label[common] == name[i + common])
+			++common;
+
+		if (common < label.size()) {
+			// Split the edge
+			Node mid;
+			mid.label = label.substr(0, common);
+			mid.children.push_back(next);
+			mid.plain = nodes[next].plain;
+			mid.paramOnly = nodes[next].paramOnly;
+			nodes[next].label.erase(0, common);
+			nodes.push_back(mid);
+			std::uint32_t midIdx = static_cast<std::uint32_t>(nodes.size() - 1);
+			std::replace(nodes[cur].children.begin(), nodes[cur].children.end(), next, midIdx);
+			next = midIdx;
+		}
+		cur = next;
+		i += common;
+	}
+
+	Node &node = nodes[cur];
+	bool isNew = (node.key == 0);
+	node.key = key;
+	if (!isNew)
+		return;
+	node.name = name;
+	++options;
+
+	// Update the amount of candidates
+	if (!name.empty() && name.back() == '=') {
+		if (find(name.data(), name.size() - 1) == 0)
+			adjust(name, 0, 1);
+	} else {
+		adjust(name, 1, 0);
+		std::string withParam = name + '=';
+		if (find(withParam.data(), withParam.size()) != 0)
+			adjust(withParam, 0, -1);
+	}
+}
+
+/**
+ * @brief Returns the key of the option with exactly the given name.
+ * @return The key, or `0` if there is no such option.
+ */
+int OptionIndex::find(const char *name, std::size_t len) const
+{
+	Cursor cursor;
+	if (!advance(cursor, name, len))
+		return 0;
+	return keyAt(cursor);
+}
+
+/**
+ * @brief Moves the cursor forward along the given characters.
+ * @return `false` if there is no option which continues with these
+ *         characters. The cursor is undefined in this case.
+ */
+bool OptionIndex::advance(Cursor &cursor, const char *str, std::size_t len) const
+{
+	for (std::size_t i = 0; i < len; ++i) {
+		const Node &node = nodes[cursor.node];
+		if (cursor.depth < node.label.size()) {
+			if (node.label[cursor.depth] != str[i])
+				return false;
+			++cursor.depth;
+		} else {
+			std::uint32_t next = child(cursor.node, str[i]);
+			if (next == 0)
+				return false;
+			cursor.node = next;
+			cursor.depth = 1;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Returns the position of the first candidate below the cursor.
+ *
+ * The behavior is undefined if countCandidates() returns `0`.
+ */
+OptionIndex::Cursor OptionIndex::firstCandidate(const Cursor &cursor, bool hasParam) const
+{
+	std::uint32_t cur = cursor.node;
+	while (nodes[cur].key == 0 || !isCandidate(nodes[cur], hasParam)) {
+		for (std::uint32_t c : nodes[cur].children) {
+			if (count(c, hasParam) > 0) {
+				cur = c;
+				break;
+			}
+		}
+	}
+	Cursor result;
+	result.node = cur;
+	result.depth = nodes[cur].label.size();
+	return result;
+}
+
+std::uint32_t OptionIndex::child(std::uint32_t node, char c) const
+{
+	for (std::uint32_t idx : nodes[node].children) {
+		if (nodes[idx].label[0] == c)
+			return idx;
+	}
+	return 0;
+}
+
+bool OptionIndex::isCandidate(const Node &node, bool hasParam) const
+{
+	const std::string &name = node.name;
+	if (name.empty() || name.back() != '=')
+		return !hasParam;
+	return find(name.data(), name.size() - 1) == 0;
+}
+
+/**
+ * @brief Adds the given values to the counters of all nodes on the path to
+ * the given option.
+ */
+void OptionIndex::adjust(const std::string &name, int plain, int paramOnly)
+{
+	Cursor cursor;
+	nodes[0].plain += plain;
+	nodes[0].paramOnly += paramOnly;
+	for (char c : name) {
+		const Node &node = nodes[cursor.node];
+		if (cursor.depth < node.label.size()) {
+			++cursor.depth;
+			continue;
+		}
+		cursor.node = child(cursor.node, c);
+		cursor.depth = 1;
+		nodes[cursor.node].plain += plain;
+		nodes[cursor.node].paramOnly += paramOnly;
+	}
+}
+
+} // namespace utl
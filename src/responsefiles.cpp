@@ -0,0 +1,198 @@
+#include "utl/responsefiles.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(unix) || defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTL_RESPONSEFILES_MMAP 1
+#else
+#include <fstream>
+#endif
+
+static bool isSpace(char c);
+
+
+namespace utl {
+
+/**
+ * @brief Expands the response files in the given arguments.
+ *
+ * @throws std::runtime_error If a response file includes itself, contains an
+ *         unterminated quote or cannot be mapped into memory.
+ */
+ResponseFiles::ResponseFiles(int argc, const char * const argv[])
+{
+	try {
+		if (argc > 0)
+			args.push_back(argv[0]);
+		for (int i = 1; i < argc; ++i) {
+			if (argv[i][0] == '@' && argv[i][1] != '\0')
+				expand(argv[i] + 1, argv[i]);
+			else
+				args.push_back(argv[i]);
+		}
+		args.push_back(nullptr);
+	} catch (...) {
+		release();
+		throw;
+	}
+}
+
+ResponseFiles::~ResponseFiles()
+{
+	release();
+}
+
+/**
+ * @brief Adds the arguments of the response file at @p path.
+ *
+ * If the file cannot be opened, @p arg is added instead.
+ */
+void ResponseFiles::expand(const char *path, const char *arg)
+{
+	Mapping mapping = {nullptr, 0};
+	std::string id;
+#ifdef UTL_RESPONSEFILES_MMAP
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0) {
+		args.push_back(arg);
+		return;
+	}
+	struct stat info;
+	if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+		::close(fd);
+		args.push_back(arg);
+		return;
+	}
+	id = std::to_string(info.st_dev) + ':' + std::to_string(info.st_ino);
+	if (std::find(expanding.begin(), expanding.end(), id) != expanding.end()) {
+		::close(fd);
+		throw std::runtime_error(std::string("Response file includes itself: ") + path);
+	}
+	mapping.size = static_cast<std::size_t>(info.st_size);
+	if (mapping.size > 0) {
+		// The mapping is private, so the file is not changed by tokenize()
+		void *data = ::mmap(nullptr, mapping.size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (data == MAP_FAILED)
+			throw std::runtime_error(std::string("Cannot map response file ") + path);
+		mapping.data = static_cast<char*>(data);
+		mappings.push_back(mapping);
+	} else {
+		::close(fd);
+	}
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		args.push_back(arg);
+		return;
+	}
+	id = path;
+	if (std::find(expanding.begin(), expanding.end(), id) != expanding.end())
+		throw std::runtime_error(std::string("Response file includes itself: ") + path);
+	file.seekg(0, std::ios::end);
+	mapping.size = static_cast<std::size_t>(file.tellg());
+	file.seekg(0, std::ios::beg);
+	if (mapping.size > 0) {
+		mapping.data = new char[mapping.size];
+		mappings.push_back(mapping);
+		file.read(mapping.data, mapping.size);
+	}
+#endif
+
+	expanding.push_back(id);
+	tokenize(mapping.data, mapping.data + mapping.size, path);
+	expanding.pop_back();
+}
+
+/**
+ * @brief Splits the content of a response file into arguments.
+ *
+ * The arguments are unquoted in place and terminated by overwriting the
+ * whitespace behind them. Every character is visited once, so the time is
+ * linear to the size of the file.
+ */
+void ResponseFiles::tokenize(char *first, char *last, const char *path)
+{
+	char *read = first;
+	while (true) {
+		while (read != last && isSpace(*read))
+			++read;
+		if (read == last)
+			break;
+		if (*read == '#') {
+			while (read != last && *read != '\n')
+				++read;
+			continue;
+		}
+
+		char *start = read, *write = read;
+		char quote = '\0';
+		for (; read != last; ++read) {
+			char c = *read;
+			if (quote == '\'') {
+				if (c == '\'')
+					quote = '\0';
+				else
+					*write++ = c;
+			} else if (c == '\\' && read + 1 != last) {
+				*write++ = *++read;
+			} else if (quote == '"') {
+				if (c == '"')
+					quote = '\0';
+				else
+					*write++ = c;
+			} else if (c == '\'' || c == '"') {
+				quote = c;
+			} else if (isSpace(c)) {
+				break;
+			} else {
+				*write++ = c;
+			}
+		}
+		if (quote != '\0')
+			throw std::runtime_error(std::string("Unterminated quote in response file ") + path);
+
+		const char *arg;
+		if (read != last) {
+			// The argument is never longer than the text it was read from
+			*write = '\0';
+			++read;
+			arg = start;
+		} else {
+			// There is no space left behind the last argument
+			copies.emplace_back(start, write);
+			arg = copies.back().c_str();
+		}
+
+		if (arg[0] == '@' && arg[1] != '\0')
+			expand(arg + 1, arg);
+		else
+			args.push_back(arg);
+	}
+}
+
+void ResponseFiles::release()
+{
+	for (const Mapping &mapping : mappings) {
+#ifdef UTL_RESPONSEFILES_MMAP
+		::munmap(mapping.data, mapping.size);
+#else
+		delete[] mapping.data;
+#endif
+	}
+	mappings.clear();
+}
+
+} // namespace utl
+
+
+bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
@@ -0,0 +1,175 @@
+#include "utl/arguments.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define UTL_SPLITTER_SSE2 1
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+static unsigned countTrailingZeros(std::uint32_t mask);
+static unsigned popCount(std::uint32_t mask);
+
+
+namespace utl {
+namespace argr {
+
+/**
+ * @brief Creates a splitter for a single delimiter.
+ *
+ * @param delimiter The character which separates the elements.
+ * @param escape    If not `'\0'`, this character makes the following
+ *                  character part of the element.
+ */
+splitter::splitter(char delimiter, char escape) :
+	splitter(std::string(1, delimiter), false, escape)
+{
+}
+
+/**
+ * @brief Creates a splitter which splits at every character in
+ * @p delimiters.
+ */
+splitter splitter::anyOf(const std::string &delimiters, char escape)
+{
+	return splitter(delimiters, false, escape);
+}
+
+/**
+ * @brief Creates a splitter which splits at the whole string
+ * @p delimiter.
+ */
+splitter splitter::sequence(const std::string &delimiter, char escape)
+{
+	return splitter(delimiter, true, escape);
+}
+
+splitter::splitter(const std::string &delimiter, bool sequence, char escape) :
+	delimiter(delimiter), isSequence(sequence), escape(escape), specialCount(0)
+{
+	assert(!delimiter.empty());
+	std::memset(isSpecial, 0, sizeof(isSpecial));
+	std::memset(isDelimiter, 0, sizeof(isDelimiter));
+
+	// A sequence is only searched by its first character
+	std::string chars = sequence ? delimiter.substr(0, 1) : delimiter;
+	if (escape != '\0')
+		chars += escape;
+	for (char c : chars) {
+		unsigned char u = static_cast<unsigned char>(c);
+		if (isSpecial[u])
+			continue;
+		isSpecial[u] = true;
+		if (specialCount < sizeof(special))
+			special[specialCount] = c;
+		++specialCount;
+	}
+	for (char c : sequence ? delimiter.substr(0, 1) : delimiter)
+		isDelimiter[static_cast<unsigned char>(c)] = true;
+}
+
+/**
+ * @brief Returns the amount of delimiters in the given range.
+ *
+ * The escape character is not considered, so the result is an upper bound
+ * for the amount of delimiters. For a sequence, only its first character is
+ * counted.
+ */
+std::size_t splitter::count(const char *first, const char *last) const
+{
+	std::size_t result = 0;
+#ifdef UTL_SPLITTER_SSE2
+	std::size_t delimiterCount = isSequence ? 1 : delimiter.size();
+	if (delimiterCount <= 4) {
+		__m128i needles[4];
+		for (std::size_t i = 0; i < delimiterCount; ++i)
+			needles[i] = _mm_set1_epi8(delimiter[i]);
+		for (; last - first >= 16; first += 16) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			__m128i match = _mm_cmpeq_epi8(block, needles[0]);
+			for (std::size_t i = 1; i < delimiterCount; ++i)
+				match = _mm_or_si128(match, _mm_cmpeq_epi8(block, needles[i]));
+			result += popCount(static_cast<std::uint32_t>(_mm_movemask_epi8(match)));
+		}
+	}
+#endif
+	for (; first != last; ++first)
+		result += isDelimiter[static_cast<unsigned char>(*first)];
+	return result;
+}
+
+/**
+ * @brief Returns the first delimiter or escape character in the given range.
+ * @return The position of the character, or @p last if there is none.
+ */
+const char *splitter::find(const char *first, const char *last) const
+{
+	if (specialCount <= sizeof(special)) {
+#ifdef __AVX2__
+		__m256i needles256[4];
+		for (std::size_t i = 0; i < specialCount; ++i)
+			needles256[i] = _mm256_set1_epi8(special[i]);
+		for (; last - first >= 32; first += 32) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+			__m256i match = _mm256_cmpeq_epi8(block, needles256[0]);
+			for (std::size_t i = 1; i < specialCount; ++i)
+				match = _mm256_or_si256(match, _mm256_cmpeq_epi8(block, needles256[i]));
+			std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+			if (mask != 0)
+				return first + countTrailingZeros(mask);
+		}
+#endif
+#ifdef UTL_SPLITTER_SSE2
+		__m128i needles[4];
+		for (std::size_t i = 0; i < specialCount; ++i)
+			needles[i] = _mm_set1_epi8(special[i]);
+		for (; last - first >= 16; first += 16) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			__m128i match = _mm_cmpeq_epi8(block, needles[0]);
+			for (std::size_t i = 1; i < specialCount; ++i)
+				match = _mm_or_si128(match, _mm_cmpeq_epi8(block, needles[i]));
+			std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(match));
+			if (mask != 0)
+				return first + countTrailingZeros(mask);
+		}
+#endif
+	}
+	for (; first != last; ++first) {
+		if (isSpecial[static_cast<unsigned char>(*first)])
+			return first;
+	}
+	return last;
+}
+
+} // namespace argr
+} // namespace utl
+
+
+unsigned countTrailingZeros(std::uint32_t mask)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+	unsigned n = 0;
+	while ((mask & 1) == 0) {
+		mask >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
+unsigned popCount(std::uint32_t mask)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+	unsigned n = 0;
+	for (; mask != 0; mask &= mask - 1)
+		++n;
+	return n;
+#endif
+}
@@ -0,0 +1,130 @@
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/argumentschema.h"
+
+using std::string;
+using utl::ArgumentSchema;
+using utl::argr::boolean;
+using utl::argr::list;
+using utl::argr::number;
+using utl::argr::withUnit;
+
+
+TEST(ArgumentSchemaTest, bindAll)
+{
+	const char *argv[] = {"./myapp", "-v", "file1", "--size=5k", "--ids", "1,2,3",
+			"--col=on", "-n", "7", "--", "--file2"};
+
+	bool verbose = false, color = false, quiet = false;
+	long size = 0;
+	int n = 0;
+	std::vector<int> ids;
+	ArgumentSchema schema;
+	schema.flag("--verbose", verbose)
+	      .flag("-v", verbose)
+	      .flag("--quiet", quiet)
+	      .option("--size=", size, withUnit<long>{{"", 1}, {"k", 1000}})
+	      .option("--ids=", ids, list(number()))
+	      .option("--color=", color, boolean())
+	      .option("-n", n, number());
+
+	std::vector<string> expected = {"file1", "--file2"};
+	EXPECT_EQ(     expected, schema.parse(11, argv));
+	EXPECT_TRUE(           verbose);
+	EXPECT_FALSE(          quiet);
+	EXPECT_TRUE(           color);
+	EXPECT_EQ(         5000, size);
+	EXPECT_EQ(            7, n);
+	EXPECT_EQ(std::vector<int>({1, 2, 3}), ids);
+}
+
+TEST(ArgumentSchemaTest, repeatedOption)
+{
+	const char *argv[] = {"./myapp", "-i", "3", "-i4", "--include=3"};
+
+	std::set<int> includes;
+	ArgumentSchema schema;
+	schema.option("-i", includes, list(number()))
+	      .option("--include=", includes, list(number()));
+
+	EXPECT_TRUE(           schema.parse(5, argv).empty());
+	EXPECT_EQ(std::set<int>({3, 4}), includes);
+}
+
+TEST(ArgumentSchemaTest, unknownOption)
+{
+	const char *argv[] = {"./myapp", "-x"};
+
+	bool verbose = false;
+	ArgumentSchema schema;
+	schema.flag("-v", verbose);
+
+	EXPECT_THROW(          schema.parse(2, argv), std::runtime_error);
+}
+
+TEST(ArgumentSchemaTest, ambiguousOption)
+{
+	const char *argv[] = {"./myapp", "--ver"};
+
+	bool verbose = false, version = false;
+	ArgumentSchema schema;
+	schema.flag("--verbose", verbose)
+	      .flag("--version", version);
+
+	EXPECT_THROW(          schema.parse(2, argv), std::runtime_error);
+}
+
+TEST(ArgumentSchemaTest, missingParameter)
+{
+	const char *argv[] = {"./myapp", "--level"};
+
+	int level = 0;
+	ArgumentSchema schema;
+	schema.option("--level=", level, number());
+
+	try {
+		schema.parse(2, argv);
+		FAIL();
+	} catch (const utl::ArgumentException &e) {
+		EXPECT_EQ(utl::ArgumentError::MISSING_ARGUMENT, e.error().kind);
+		EXPECT_EQ(        2u, e.error().position);
+		EXPECT_EQ("--level=", e.error().token);
+	}
+}
+
+TEST(ArgumentSchemaTest, invalidParameter)
+{
+	const char *argv[] = {"./myapp", "-v", "--level=high"};
+
+	bool verbose = false;
+	int level = 0;
+	ArgumentSchema schema;
+	schema.flag("-v", verbose)
+	      .option("--level=", level, number());
+
+	try {
+		schema.parse(3, argv);
+		FAIL();
+	} catch (const utl::ArgumentException &e) {
+		EXPECT_EQ(utl::ArgumentError::INVALID_ARGUMENT, e.error().kind);
+		EXPECT_EQ(        2u, e.error().position);
+		EXPECT_EQ(    "high", e.error().token);
+	}
+}
+
+TEST(ArgumentSchemaTest, duplicateName)
+{
+	bool verbose = false;
+	int level = 0;
+	ArgumentSchema schema;
+	schema.flag("--verbose", verbose);
+
+	EXPECT_THROW(          schema.flag("--verbose", verbose), std::invalid_argument);
+	EXPECT_THROW(          schema.option("--verbose", level), std::invalid_argument);
+	EXPECT_NO_THROW(       schema.option("--verbose=", level));
+}
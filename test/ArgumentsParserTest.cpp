@@ -10,7 +10,10 @@
 using std::string;
 using utl::Arguments;
 using utl::argr::boolean;
+using utl::argr::fromStream;
 using utl::argr::list;
+using utl::argr::number;
+using utl::argr::splitter;
 
 
 utl::argr::withUnit<long> testUnit{
@@ -162,6 +165,129 @@ TEST(ArgumentsParserTest, doubleFailDot)
 	EXPECT_THROW(     args.getNextArgument(arg), std::exception);
 }
 
+// ---------------------------------------------------------------------------
+// number
+
+TEST(ArgumentsParserTest, numberInteger)
+{
+	const char *argv[] = {"./myapp", "0", "-1", "50", "+7", "0x1F", "0b101",
+				"-2147483648", "2147483647"};
+	Arguments args(9, argv);
+
+	int arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(     0, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(    -1, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(    50, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(     7, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(    31, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(     5, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(INT32_MIN, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(INT32_MAX, arg);
+}
+
+TEST(ArgumentsParserTest, numberIntegerFail)
+{
+	const char *argv[] = {"./myapp", "", "42Suffix", "Pre24", "-", "0x",
+				"2147483648", "-2147483649", "1.5", " 1"};
+	for (int i = 1; i < 10; ++i) {
+		const char *sub[] = {"./myapp", argv[i]};
+		Arguments args(2, sub);
+		int arg;
+		EXPECT_THROW( args.getNextArgument(arg, number()), std::exception) << argv[i];
+	}
+}
+
+TEST(ArgumentsParserTest, numberUnsigned)
+{
+	const char *argv[] = {"./myapp", "255", "256", "-1"};
+	Arguments args(4, argv);
+
+	unsigned char arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(   255, arg);
+	EXPECT_THROW(     args.getNextArgument(arg, number()), std::exception);
+	EXPECT_THROW(     args.getNextArgument(arg, number()), std::exception);
+}
+
+TEST(ArgumentsParserTest, numberBool)
+{
+	const char *argv[] = {"./myapp", "1", "0", "2"};
+	Arguments args(4, argv);
+
+	bool arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_TRUE(      arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_FALSE(     arg);
+	EXPECT_THROW(     args.getNextArgument(arg, number()), std::exception);
+}
+
+TEST(ArgumentsParserTest, numberDouble)
+{
+	const char *argv[] = {"./myapp", "0.0", "0.1", "-1.1", "50.", ".5", "1e3",
+				"2.5E-3", "123456789012345678901234567890"};
+	Arguments args(9, argv);
+
+	double arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(   0.0, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(   0.1, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(  -1.1, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(  50.0, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(   0.5, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(1000.0, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(2.5E-3, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(123456789012345678901234567890.0, arg);
+}
+
+TEST(ArgumentsParserTest, numberLongDouble)
+{
+	// 2^53 + 1 is exact only with more than 53 bits of mantissa
+	const char *argv[] = {"./myapp", "9007199254740993", "0.1"};
+	Arguments args(3, argv);
+
+	long double arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(9007199254740993.0L, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, number()));
+	EXPECT_EQ(  0.1L, arg);
+}
+
+TEST(ArgumentsParserTest, numberDoubleFail)
+{
+	const char *argv[] = {"./myapp", "", "42+", "#24", ".", "1e999", "-", "1e"};
+	for (int i = 1; i < 8; ++i) {
+		const char *sub[] = {"./myapp", argv[i]};
+		Arguments args(2, sub);
+		double arg;
+		EXPECT_THROW( args.getNextArgument(arg, number()), std::exception) << argv[i];
+	}
+}
+
+TEST(ArgumentsParserTest, numberFloatOverflow)
+{
+	const char *argv[] = {"./myapp", "1e39"};
+	Arguments args(2, argv);
+
+	float arg;
+	EXPECT_THROW(     args.getNextArgument(arg, number()), std::exception);
+}
+
 // ---------------------------------------------------------------------------
 // unit
 
@@ -222,6 +348,27 @@ TEST(ArgumentsParserTest, unitFailPrefix)
 	EXPECT_THROW(     args.getNextArgument(arg, testUnit), std::exception);
 }
 
+TEST(ArgumentsParserTest, unitLeadingWhitespace)
+{
+	const char *argv[] = {"./myapp", " 2k", "\t0"};
+	Arguments args(3, argv);
+
+	int arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, testUnit));
+	EXPECT_EQ(  2000, arg);
+	EXPECT_TRUE(      args.getNextArgument(arg, testUnit));
+	EXPECT_EQ(     0, arg);
+}
+
+TEST(ArgumentsParserTest, unitFailUnsignedNegative)
+{
+	const char *argv[] = {"./myapp", "-1k"};
+	Arguments args(2, argv);
+
+	unsigned arg;
+	EXPECT_THROW(     args.getNextArgument(arg, testUnit), std::exception);
+}
+
 TEST(ArgumentsParserTest, integerFailNotFound)
 {
 	const char *argv[] = {"./myapp", "24L"};
@@ -338,6 +485,47 @@ TEST(ArgumentsParserTest, booleanFail00)
 }
 
 // ---------------------------------------------------------------------------
+// tryGetNextArgument
+
+TEST(ArgumentsParserTest, tryGetNextArgument)
+{
+	// "abc" reuses the buffer of the longer "12345"
+	const char *argv[] = {"./myapp", "12345", "abc", "--", "7"};
+	Arguments args(5, argv);
+
+	utl::ArgumentError error;
+	int arg = 0;
+	EXPECT_EQ(         0, args.getNextOption());
+	EXPECT_TRUE(          args.tryGetNextArgument(arg, error, number()));
+	EXPECT_EQ(     12345, arg);
+	EXPECT_FALSE(         error);
+	EXPECT_FALSE(         args.tryGetNextArgument(arg, error, number()));
+	EXPECT_EQ(utl::ArgumentError::INVALID_ARGUMENT, error.kind);
+	EXPECT_EQ(        2u, error.position);
+	EXPECT_EQ(     "abc", error.token);
+	EXPECT_TRUE(          args.tryGetNextArgument(arg, error));
+	EXPECT_EQ(         7, arg);
+	EXPECT_FALSE(         args.tryGetNextArgument(arg, error));
+	EXPECT_EQ(utl::ArgumentError::MISSING_ARGUMENT, error.kind);
+}
+
+TEST(ArgumentsParserTest, argumentException)
+{
+	const char *argv[] = {"./myapp", "-x", "abc"};
+	Arguments args(3, argv);
+
+	int arg = 0;
+	EXPECT_EQ(       'x', args.getNextOption());
+	try {
+		args.getNextArgument(arg, number());
+		FAIL();
+	} catch (const utl::ArgumentException &e) {
+		EXPECT_EQ(utl::ArgumentError::INVALID_ARGUMENT, e.error().kind);
+		EXPECT_EQ(    2u, e.error().position);
+		EXPECT_EQ(string("Invalid argument abc"), e.what());
+	}
+}
+
 // list
 
 TEST(ArgumentsParserTest, list555)
@@ -406,6 +594,69 @@ TEST(ArgumentsParserTest, listCustomDelimeter)
 	EXPECT_EQ(expected, arg);
 }
 
+TEST(ArgumentsParserTest, listAnyOf)
+{
+	const char *argv[] = {"./myapp", "1,2;3 4"};
+	Arguments args(2, argv);
+
+	std::vector<int> arg;
+	std::vector<int> expected = {1, 2, 3, 4};
+	EXPECT_TRUE(      args.getNextArgument(arg, list(number(), splitter::anyOf(",; "))));
+	EXPECT_EQ(expected, arg);
+}
+
+TEST(ArgumentsParserTest, listSequence)
+{
+	const char *argv[] = {"./myapp", "a::b:c:::d:"};
+	Arguments args(2, argv);
+
+	std::vector<string> arg;
+	std::vector<string> expected = {"a", "b:c", ":d:"};
+	EXPECT_TRUE(      args.getNextArgument(arg, list(fromStream(), splitter::sequence("::"))));
+	EXPECT_EQ(expected, arg);
+}
+
+TEST(ArgumentsParserTest, listEscape)
+{
+	const char *argv[] = {"./myapp", "a\\,b,c\\\\,d\\"};
+	Arguments args(2, argv);
+
+	std::vector<string> arg;
+	std::vector<string> expected = {"a,b", "c\\", "d\\"};
+	EXPECT_TRUE(      args.getNextArgument(arg, list(fromStream(), splitter(',', '\\'))));
+	EXPECT_EQ(expected, arg);
+}
+
+TEST(ArgumentsParserTest, listLong)
+{
+	// Longer than the blocks which are searched at once
+	string list1000;
+	std::vector<int> expected;
+	for (int i = 0; i < 1000; ++i) {
+		list1000 += (i == 0 ? "" : ",") + std::to_string(i);
+		expected.push_back(i);
+	}
+	const char *argv[] = {"./myapp", list1000.c_str()};
+	Arguments args(2, argv);
+
+	std::vector<int> arg;
+	EXPECT_TRUE(      args.getNextArgument(arg, list(number())));
+	EXPECT_EQ(expected, arg);
+}
+
+TEST(ArgumentsParserTest, listLongElements)
+{
+	string a(40, 'a'), b(70, 'b');
+	string value = a + ";" + b;
+	const char *argv[] = {"./myapp", value.c_str()};
+	Arguments args(2, argv);
+
+	std::vector<string> arg;
+	std::vector<string> expected = {a, b};
+	EXPECT_TRUE(      args.getNextArgument(arg, list(fromStream(), splitter::anyOf(",;"))));
+	EXPECT_EQ(expected, arg);
+}
+
 TEST(ArgumentsParserTest, listFail1)
 {
 	const char *argv[] = {"./myapp", "6,9,f"};
@@ -1,4 +1,7 @@
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -794,3 +797,377 @@ TEST(ArgumentsTest, mix)
 	EXPECT_EQ(         0, args.getNextOption());
 	EXPECT_EQ(         0, args.getArgumentsLeft());
 }
+
+TEST(ArgumentsTest, longOptionManyOptions)
+{
+	const char *argv[] = {"./myapp", "--option12", "--option12=", "--option2",
+				"--opt", "--other", "--other=x"};
+	Arguments args(7, argv);
+	for (int i = 1; i < 300; ++i)
+		args.registerOption("--option" + std::to_string(i), i);
+	args.registerOption("--option12=", 1000);
+	args.registerOption("--otherwise=", 1001);
+
+	string param;
+	EXPECT_EQ(        12, args.getNextOption());
+	EXPECT_EQ("--option12", args.getOptionName());
+	EXPECT_EQ(      1000, args.getNextOption());
+	EXPECT_EQ("--option12=", args.getOptionName());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(        "", param);
+	EXPECT_EQ(         2, args.getNextOption());
+	EXPECT_EQ( "--option2", args.getOptionName());
+	EXPECT_EQ(        -2, args.getNextOption());
+	EXPECT_EQ(     "--opt", args.getOptionName());
+	EXPECT_EQ(       299, args.getPossibleOptions().size());
+	EXPECT_EQ(      1001, args.getNextOption());
+	EXPECT_EQ("--otherwise=", args.getOptionName());
+	EXPECT_EQ(      1001, args.getNextOption());
+	EXPECT_EQ("--otherwise=", args.getOptionName());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(       "x", param);
+	EXPECT_EQ(         0, args.getNextOption());
+}
+
+static constexpr utl::OptionDef TABLE_OPTIONS[] = {
+	{"--test",   'x'},
+	{"--test2=", 'z'},
+	{"--test=",  'y'},
+	{"--verbose", 'v'},
+	{"-q",       'Q'}
+};
+static_assert(utl::OptionTable(TABLE_OPTIONS).isSorted(), "TABLE_OPTIONS is not sorted");
+
+TEST(ArgumentsTest, tableSorted)
+{
+	static constexpr utl::OptionDef unsorted[] = {{"--b", 1}, {"--a", 2}};
+	static constexpr utl::OptionDef duplicate[] = {{"--a", 1}, {"--a", 2}};
+	static constexpr utl::OptionDef prefix[] = {{"--a", 1}, {"--a=", 2}};
+	EXPECT_FALSE(utl::OptionTable(unsorted).isSorted());
+	EXPECT_FALSE(utl::OptionTable(duplicate).isSorted());
+	EXPECT_TRUE(utl::OptionTable(prefix).isSorted());
+}
+
+// 600 options, more than the default constexpr depth of GCC
+#define LARGE_OPTION(n)   {"--option" #n, n}
+#define LARGE_OPTIONS10(n) LARGE_OPTION(n##0), LARGE_OPTION(n##1), LARGE_OPTION(n##2), \
+		LARGE_OPTION(n##3), LARGE_OPTION(n##4), LARGE_OPTION(n##5), LARGE_OPTION(n##6), \
+		LARGE_OPTION(n##7), LARGE_OPTION(n##8), LARGE_OPTION(n##9)
+#define LARGE_OPTIONS100(n) LARGE_OPTIONS10(n##0), LARGE_OPTIONS10(n##1), \
+		LARGE_OPTIONS10(n##2), LARGE_OPTIONS10(n##3), LARGE_OPTIONS10(n##4), \
+		LARGE_OPTIONS10(n##5), LARGE_OPTIONS10(n##6), LARGE_OPTIONS10(n##7), \
+		LARGE_OPTIONS10(n##8), LARGE_OPTIONS10(n##9)
+static constexpr utl::OptionDef LARGE_TABLE_OPTIONS[] = {
+	LARGE_OPTIONS100(1), LARGE_OPTIONS100(2), LARGE_OPTIONS100(3),
+	LARGE_OPTIONS100(4), LARGE_OPTIONS100(5), LARGE_OPTIONS100(6)
+};
+static_assert(utl::OptionTable(LARGE_TABLE_OPTIONS).isSorted(), "LARGE_TABLE_OPTIONS is not sorted");
+
+TEST(ArgumentsTest, tableLarge)
+{
+	const char *argv[] = {"./myapp", "--option427", "--option6"};
+	Arguments args(3, argv, utl::OptionTable(LARGE_TABLE_OPTIONS));
+
+	EXPECT_EQ(       600, utl::OptionTable(LARGE_TABLE_OPTIONS).size());
+	EXPECT_EQ(       427, args.getNextOption());
+	EXPECT_EQ(        -2, args.getNextOption());
+	EXPECT_EQ(         0, args.getNextOption());
+}
+
+TEST(ArgumentsTest, tableMix)
+{
+	const char *argv[] = {"./myapp", "-qx", "--test=param1", "arg1",
+				"--test", "--test2", "param2", "--verb", "--t", "--unknown"};
+	Arguments args(10, argv, utl::OptionTable(TABLE_OPTIONS));
+
+	std::map<string,int> expected {
+		std::make_pair("--test",   'x'),
+		std::make_pair("--test2=", 'z')
+	};
+
+	string param;
+	EXPECT_EQ(       'Q', args.getNextOption());
+	EXPECT_EQ(      "-q", args.getOptionName());
+	EXPECT_EQ(       'x', args.getNextOption());
+	EXPECT_EQ(      "-x", args.getOptionName());
+	EXPECT_EQ(       'y', args.getNextOption());
+	EXPECT_EQ( "--test=", args.getOptionName());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(  "param1", param);
+	EXPECT_EQ(       'x', args.getNextOption());
+	EXPECT_EQ(  "--test", args.getOptionName());
+	EXPECT_EQ(       'z', args.getNextOption());
+	EXPECT_EQ("--test2=", args.getOptionName());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(  "param2", param);
+	EXPECT_EQ(       'v', args.getNextOption());
+	EXPECT_EQ("--verbose", args.getOptionName());
+	EXPECT_EQ(        -2, args.getNextOption());
+	EXPECT_EQ(     "--t", args.getOptionName());
+	EXPECT_EQ(  expected, args.getPossibleOptions());
+	EXPECT_EQ(        -1, args.getNextOption());
+	EXPECT_EQ("--unknown", args.getOptionName());
+	EXPECT_EQ(         0, args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(    "arg1", param);
+	EXPECT_FALSE(         args.getNextArgument(param));
+}
+
+TEST(ArgumentsTest, tableParamBetween)
+{
+	static constexpr utl::OptionDef options[] = {{"--a-b", 1}, {"--a=", 2}, {"--ab", 3}};
+	const char *argv[] = {"./myapp", "--a", "x", "-q"};
+	Arguments args(4, argv, utl::OptionTable(options));
+
+	string param;
+	EXPECT_EQ(         2, args.getNextOption());
+	EXPECT_EQ(    "--a=", args.getOptionName());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(       "x", param);
+	EXPECT_EQ(       'q', args.getNextOption());
+
+	// The copy keeps its own short option
+	Arguments copy(args);
+	EXPECT_EQ(      "-q", copy.getOptionName());
+	EXPECT_EQ(         0, copy.getNextOption());
+}
+
+TEST(ArgumentsTest, tableStrict)
+{
+	const char *argv[] = {"./myapp", "-q", "-x"};
+	Arguments args(3, argv, utl::OptionTable(TABLE_OPTIONS), true);
+
+	EXPECT_EQ(       'Q', args.getNextOption());
+	EXPECT_EQ(        -1, args.getNextOption());
+	EXPECT_EQ(      "-x", args.getOptionName());
+	EXPECT_EQ(         0, args.getNextOption());
+}
+
+TEST(ArgumentsTest, sharedIndex)
+{
+	const char *argv[] = {"./myapp", "--te", "--verb", "-x", "file"};
+	utl::OptionIndex options;
+	options.insert("--test", 't');
+	options.insert("--test2", 'T');
+	options.insert("--verbose", 'v');
+	Arguments args(5, argv, options, true);
+
+	string param;
+	EXPECT_EQ(        -2, args.getNextOption());
+	EXPECT_EQ(        2u, args.getPossibleOptions().size());
+	EXPECT_EQ(       'v', args.getNextOption());
+	EXPECT_EQ(        -1, args.getNextOption());
+	EXPECT_EQ(         0, args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(    "file", param);
+}
+
+TEST(ArgumentsTest, reset)
+{
+	const char *argv1[] = {"./myapp", "arg1", "--test=x", "--te"};
+	const char *argv2[] = {"./myapp", "--test", "arg2"};
+	Arguments args(4, argv1);
+	args.registerOption("--test=", 't');
+	args.registerOption("--test2", 'T');
+
+	string param;
+	EXPECT_EQ(       't', args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(        -2, args.getNextOption());
+
+	args.reset(3, argv2);
+	EXPECT_EQ(         2, args.getArgumentsLeft());
+	EXPECT_EQ(       't', args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(    "arg2", param);
+	EXPECT_EQ(         0, args.getNextOption());
+	EXPECT_FALSE(         args.getNextArgument(param));
+}
+
+TEST(ArgumentsTest, sharedIndexThreads)
+{
+	utl::OptionIndex options;
+	options.insert("--level=", 'l');
+	options.insert("--verbose", 'v');
+
+	std::vector<int> sums(4);
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < sums.size(); ++t) {
+		threads.emplace_back([&options, &sums, t]() {
+			Arguments args(0, nullptr, options);
+			for (int i = 0; i < 1000; ++i) {
+				string level = "--lev=" + std::to_string(i);
+				const char *argv[] = {"./myapp", "--verb", level.c_str()};
+				args.reset(3, argv);
+				int value;
+				while (int opt = args.getNextOption()) {
+					if (opt == 'l' && args.getNextArgument(value))
+						sums[t] += value;
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	for (int sum : sums)
+		EXPECT_EQ(    499500, sum);
+}
+
+TEST(ArgumentsTest, copy)
+{
+	const char *argv[] = {"./myapp", "--verbose", "-x"};
+	Arguments args(3, argv);
+	args.registerOption("--verbose", 'v');
+
+	Arguments copy(args);
+	copy.registerOption("-x", 'x');
+	EXPECT_EQ(       'v', copy.getNextOption());
+	EXPECT_EQ(       'x', copy.getNextOption());
+
+	// Registering in the copy does not change the original
+	Arguments strict(3, argv, true);
+	strict.registerOption("--verbose", 'v');
+	EXPECT_EQ(       'v', strict.getNextOption());
+	EXPECT_EQ(        -1, strict.getNextOption());
+
+	strict = args;
+	EXPECT_EQ(       'v', strict.getNextOption());
+	EXPECT_EQ(       'v', args.getNextOption());
+	EXPECT_EQ(       'x', args.getNextOption());
+	args.registerOption("-x", 'y');
+	EXPECT_EQ(       'x', strict.getNextOption());
+}
+
+TEST(ArgumentsTest, tryGetNextOption)
+{
+	const char *argv[] = {"./myapp", "file", "--verb", "--te", "-xy", "--test2"};
+	Arguments args(6, argv, true);
+	args.registerOption("--test", 't');
+	args.registerOption("--test2", 'T');
+	args.registerOption("--verbose", 'v');
+	args.registerOption("-x", 'x');
+
+	utl::ArgumentError error;
+	EXPECT_EQ(       'v', args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+	EXPECT_EQ(         0, args.tryGetNextOption(error));
+	EXPECT_EQ(utl::ArgumentError::AMBIGUOUS_OPTION, error.kind);
+	EXPECT_EQ(        3u, error.position);
+	EXPECT_EQ(    "--te", error.token);
+	EXPECT_EQ(std::vector<string>({"--test", "--test2"}), error.candidates);
+	EXPECT_EQ("Ambiguous option --te (possible options: --test --test2)", error.message());
+	EXPECT_EQ(       'x', args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+	EXPECT_EQ(         0, args.tryGetNextOption(error));
+	EXPECT_EQ(utl::ArgumentError::UNKNOWN_OPTION, error.kind);
+	EXPECT_EQ(        4u, error.position);
+	EXPECT_EQ(      "-y", error.token);
+	EXPECT_TRUE(          error.candidates.empty());
+	EXPECT_EQ(       'T', args.tryGetNextOption(error));
+	EXPECT_EQ(         0, args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+}
+
+TEST(ArgumentsTest, tryGetNextOptionNonAscii)
+{
+	// Short options outside of ASCII are keys, not errors
+	const char *argv[] = {"./myapp", "-\xe9", "-\xff"};
+	Arguments args(3, argv);
+
+	utl::ArgumentError error;
+	EXPECT_EQ(      0xe9, args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+	EXPECT_EQ(      0xff, args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+	EXPECT_EQ(         0, args.tryGetNextOption(error));
+	EXPECT_FALSE(         error);
+}
+
+TEST(ArgumentsTest, complete)
+{
+	const char *argv[] = {"./myapp"};
+	Arguments args(1, argv);
+	args.registerOption("--debug", 'd');
+	args.registerOption("--debug=", 'D');
+	args.registerOption("--level=", 'l');
+	args.registerOption("--list", 'L');
+	args.registerOption("-q", 'q');
+
+	EXPECT_EQ(std::vector<string>({"--debug", "--level=", "--list", "-q"}), args.complete(""));
+	EXPECT_EQ(std::vector<string>({"--level=", "--list"}), args.complete("--l"));
+	EXPECT_EQ(std::vector<string>({"--debug"}), args.complete("--debug"));
+	EXPECT_TRUE(          args.complete("--x").empty());
+	EXPECT_TRUE(          args.complete("--level=").empty());
+}
+
+TEST(ArgumentsTest, completeTable)
+{
+	const char *argv[] = {"./myapp"};
+	Arguments args(1, argv, utl::OptionTable(TABLE_OPTIONS));
+
+	EXPECT_EQ(std::vector<string>({"--test", "--test2="}), args.complete("--t"));
+	EXPECT_EQ(std::vector<string>({"-q"}), args.complete("-q"));
+}
+
+TEST(ArgumentsTest, handleCompletion)
+{
+	const char *argv1[] = {"./myapp", "--complete", "--ver"};
+	const char *argv2[] = {"./myapp", "--verbose"};
+	utl::OptionIndex options;
+	options.insert("--verbose", 'v');
+	options.insert("--version", 'V');
+	options.insert("--quiet", 'q');
+
+	std::ostringstream out;
+	EXPECT_TRUE(          Arguments(3, argv1, options).handleCompletion(out));
+	EXPECT_EQ("--verbose\n--version\n", out.str());
+	EXPECT_FALSE(         Arguments(2, argv2, options).handleCompletion(out));
+}
+
+TEST(ArgumentsTest, completionScript)
+{
+	const char *argv[] = {"./myapp"};
+	Arguments args(1, argv);
+	args.registerOption("--debug", 'd');
+	args.registerOption("--level=", 'l');
+
+	std::ostringstream bash, zsh;
+	args.writeCompletionScript(bash, Arguments::BASH, "my-app");
+	args.writeCompletionScript(zsh, Arguments::ZSH, "my-app");
+	EXPECT_NE(string::npos, bash.str().find("compgen -W \"--debug --level=\""));
+	EXPECT_NE(string::npos, bash.str().find("complete -o filenames -F _my_app 'my-app'"));
+	EXPECT_EQ("#compdef my-app\n"
+	          "_arguments -s \\\n"
+	          "    '--debug' \\\n"
+	          "    '--level=:value: ' \\\n"
+	          "    '*:file:_files'\n", zsh.str());
+}
+
+#ifdef UTL_HAS_STRING_VIEW
+TEST(ArgumentsTest, stringViewMix)
+{
+	const char *argv[] = {"./myapp", "arg1", "-xparam1", "--test=param2", "arg2"};
+	Arguments args(5, argv);
+	args.registerOption("--test=", 'y');
+
+	std::string_view param;
+	EXPECT_EQ(         4, args.getArgumentsLeft());
+	EXPECT_EQ(       'x', args.getNextOption());
+	EXPECT_EQ(      "-x", args.getOptionNameView());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(  "param1", param);
+	EXPECT_EQ(argv[2] + 2, param.data());
+	EXPECT_EQ(       'y', args.getNextOption());
+	EXPECT_EQ( "--test=", args.getOptionNameView());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(  "param2", param);
+	EXPECT_EQ(         2, args.getArgumentsLeft());
+	EXPECT_EQ(         0, args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(   argv[1], param.data());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(   argv[4], param.data());
+	EXPECT_EQ(         0, args.getArgumentsLeft());
+	EXPECT_FALSE(         args.getNextArgument(param));
+}
+#endif
@@ -0,0 +1,180 @@
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/bufferedlogcontext.h"
+#include "utl/log/logger.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::BufferedLogContext;
+using utl::log::LogLevel;
+using utl::log::Logger;
+
+
+TEST(BufferedLogContextTest, discardOnSuccess)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	{
+		BufferedLogContext context;
+		EXPECT_EQ(&context, BufferedLogContext::current());
+		logger.log(LogLevel::FINE, "first");
+		logger.log(LogLevel::INFO, "second");
+		EXPECT_EQ(                2, context.size());
+		EXPECT_EQ(                0, handler->records.size());
+	}
+	EXPECT_EQ(          nullptr, BufferedLogContext::current());
+	EXPECT_EQ(                0, handler->records.size());
+
+	logger.log(LogLevel::FINE, "third");
+	EXPECT_EQ(                1, handler->records.size());
+}
+
+TEST(BufferedLogContextTest, flushOnFailure)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::FINE);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	BufferedLogContext context;
+	logger.log(LogLevel::FINEST, "filtered");
+	logger.log(LogLevel::FINE, "first");
+	logger.log(LogLevel::INFO, "second");
+	EXPECT_EQ(                2, context.size());
+	logger.log(LogLevel::WARNING, "failed");
+	EXPECT_TRUE(context.isFlushed());
+	EXPECT_EQ(                0, context.size());
+	ASSERT_EQ(                3, handler->records.size());
+	EXPECT_EQ(   LogLevel::FINE, handler->records[0].level);
+	EXPECT_EQ(          "first", handler->records[0].message);
+	EXPECT_EQ(   LogLevel::INFO, handler->records[1].level);
+	EXPECT_EQ(         "second", handler->records[1].message);
+	EXPECT_EQ(LogLevel::WARNING, handler->records[2].level);
+	EXPECT_EQ(         "failed", handler->records[2].message);
+
+	// Records after the failure are passed on directly
+	logger.log(LogLevel::FINE, "after");
+	EXPECT_EQ(                4, handler->records.size());
+
+	context.discard();
+	logger.log(LogLevel::FINE, "next");
+	EXPECT_EQ(                4, handler->records.size());
+	EXPECT_EQ(                1, context.size());
+}
+
+TEST(BufferedLogContextTest, loggerName)
+{
+	auto handler = std::make_shared<CollectingHandler>();
+	Logger &logger = Logger::get("BufferedLogContextTest.loggerName");
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(handler);
+
+	BufferedLogContext context(LogLevel::INFO);
+	logger.log(LogLevel::FINE, "first");
+	context.flush();
+	logger.removeHandler(handler);
+
+	ASSERT_EQ(                1, handler->records.size());
+	EXPECT_EQ("BufferedLogContextTest.loggerName", handler->records[0].loggerName);
+	EXPECT_EQ(          "first", handler->records[0].message);
+}
+
+TEST(BufferedLogContextTest, keepLoggerAlive)
+{
+	Logger &root = Logger::getRoot();
+	LogLevel rootLevel = root.getLevel();
+	root.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	root.addHandler(handler);
+	Logger::sweep();
+	std::size_t size = Logger::getRegistrySize();
+
+	{
+		BufferedLogContext context;
+		Logger::getP("BufferedLogContextTest.conn.1")->log(LogLevel::FINE, "opened");
+		// The stored record keeps the unconfigured logger in the registry
+		EXPECT_EQ(                0, Logger::sweep());
+		EXPECT_EQ(         size + 1, Logger::getRegistrySize());
+		root.log(LogLevel::WARNING, "failed");
+	}
+	EXPECT_EQ(                    1, Logger::sweep());
+	root.removeHandler(handler);
+	root.setLevel(rootLevel);
+
+	ASSERT_EQ(                    2, handler->records.size());
+	EXPECT_EQ("BufferedLogContextTest.conn.1", handler->records[0].loggerName);
+	EXPECT_EQ(             "opened", handler->records[0].message);
+	EXPECT_EQ(             "failed", handler->records[1].message);
+}
+
+TEST(BufferedLogContextTest, capacity)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	BufferedLogContext context(LogLevel::WARNING, 10);
+	logger.log(LogLevel::FINE, "12345");
+	logger.log(LogLevel::FINE, "67890");
+	logger.log(LogLevel::FINE, "x");
+	EXPECT_EQ(                2, context.size());
+	EXPECT_EQ(                1, context.getDroppedRecords());
+	logger.log(LogLevel::SEVERE, "failed");
+	EXPECT_EQ(                3, handler->records.size());
+}
+
+TEST(BufferedLogContextTest, nested)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	BufferedLogContext outer;
+	logger.log(LogLevel::FINE, "outer");
+	{
+		BufferedLogContext inner;
+		EXPECT_EQ(   &inner, BufferedLogContext::current());
+		logger.log(LogLevel::FINE, "inner");
+	}
+	EXPECT_EQ(       &outer, BufferedLogContext::current());
+	EXPECT_EQ(            1, outer.size());
+	EXPECT_EQ(            0, handler->records.size());
+}
+
+TEST(BufferedLogContextTest, transfer)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	BufferedLogContext context;
+	logger.log(LogLevel::FINE, "first");
+	context.detach();
+	EXPECT_FALSE(context.isAttached());
+	EXPECT_EQ(          nullptr, BufferedLogContext::current());
+
+	std::thread thread([&]() {
+		EXPECT_EQ(      nullptr, BufferedLogContext::current());
+		context.attach();
+		logger.log(LogLevel::FINE, "second");
+		logger.log(LogLevel::WARNING, "failed");
+		context.detach();
+	});
+	thread.join();
+
+	ASSERT_EQ(                3, handler->records.size());
+	EXPECT_EQ(          "first", handler->records[0].message);
+	EXPECT_EQ(         "second", handler->records[1].message);
+	EXPECT_EQ(         "failed", handler->records[2].message);
+}
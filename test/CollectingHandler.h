@@ -0,0 +1,23 @@
+#ifndef UTL_TEST_COLLECTINGHANDLER_H
+#define UTL_TEST_COLLECTINGHANDLER_H
+
+#include <vector>
+
+#include "utl/log/loghandler.h"
+#include "utl/log/logrecord.h"
+
+
+/**
+ * @brief A handler which keeps all published records, for the tests.
+ */
+class CollectingHandler : public utl::log::LogHandler
+{
+public:
+	std::vector<utl::log::LogRecord> records;
+protected:
+	virtual void publish(const utl::log::LogRecord &record) override {
+		records.push_back(record);
+	}
+};
+
+#endif // UTL_TEST_COLLECTINGHANDLER_H
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/compressedfileloghandler.h"
+#include "utl/log/compressedreader.h"
+#include "utl/log/compressedwriter.h"
+#include "utl/log/lz.h"
+
+using std::string;
+using utl::log::CompressedFileLogHandler;
+using utl::log::CompressedReader;
+using utl::log::CompressedWriter;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+namespace lz = utl::log::lz;
+
+
+static string tempFile(const char *name)
+{
+	string path = "/tmp/utl_" + std::to_string(::getpid()) + "_" + name;
+	std::remove(path.c_str());
+	return path;
+}
+
+static string roundTrip(const string &input)
+{
+	string compressed, output;
+	lz::compress(input.data(), input.size(), compressed);
+	EXPECT_TRUE(lz::decompress(compressed.data(), compressed.size(), output));
+	return output;
+}
+
+
+TEST(CompressedLogTest, codecRoundTrip)
+{
+	string repeated;
+	for (int i = 0; i < 1000; ++i)
+		repeated += "[INFO][server] request " + std::to_string(i % 17) + " done\n";
+	string random;
+	for (unsigned i = 0, x = 1; i < 5000; ++i, x = x * 1103515245 + 12345)
+		random.push_back(static_cast<char>(x >> 16));
+
+	EXPECT_EQ(              "", roundTrip(""));
+	EXPECT_EQ(             "a", roundTrip("a"));
+	EXPECT_EQ(  string(300, 'x'), roundTrip(string(300, 'x')));
+	EXPECT_EQ(        repeated, roundTrip(repeated));
+	EXPECT_EQ(          random, roundTrip(random));
+
+	string compressed;
+	lz::compress(repeated.data(), repeated.size(), compressed);
+	EXPECT_LT(compressed.size() * 4, repeated.size());
+}
+
+TEST(CompressedLogTest, codecCorrupt)
+{
+	string output;
+	// match with an offset in front of the block
+	const char data[] = {0x10, 'a', 0x05, 0x00};
+	EXPECT_FALSE(lz::decompress(data, sizeof(data), output));
+	// literal length beyond the end
+	const char data2[] = {static_cast<char>(0xF0), 0x20, 'a'};
+	EXPECT_FALSE(lz::decompress(data2, sizeof(data2), output));
+}
+
+TEST(CompressedLogTest, writerAppendAndRead)
+{
+	string path = tempFile("append.ulz");
+	string expected;
+	{
+		CompressedWriter writer(path, 256);
+		for (int i = 0; i < 100; ++i) {
+			string line = "line " + std::to_string(i) + "\n";
+			writer.write(line);
+			expected += line;
+		}
+		EXPECT_TRUE(writer.good());
+	}
+	{
+		CompressedWriter writer(path, 256);
+		writer.write("appended\n");
+		expected += "appended\n";
+		writer.flush();
+		EXPECT_EQ(9, writer.getBytesIn());
+		EXPECT_LT(0, writer.getBytesOut());
+	}
+
+	std::ostringstream out;
+	CompressedReader(path).copyTo(out);
+	EXPECT_EQ(expected, out.str());
+
+	// skip the first block
+	string first, second;
+	ASSERT_TRUE(CompressedReader(path).nextBlock(first));
+	CompressedReader reader(path);
+	EXPECT_TRUE(reader.skipBlock());
+	EXPECT_TRUE(reader.nextBlock(second));
+	EXPECT_EQ(expected.substr(first.size(), second.size()), second);
+	std::remove(path.c_str());
+}
+
+TEST(CompressedLogTest, readerCorrupt)
+{
+	string path = tempFile("corrupt.ulz");
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "no compressed log file";
+	}
+	CompressedReader reader(path);
+	string text;
+	EXPECT_THROW(reader.nextBlock(text), std::runtime_error);
+	std::remove(path.c_str());
+}
+
+TEST(CompressedLogTest, handler)
+{
+	string path = tempFile("handler.ulz");
+	{
+		CompressedFileLogHandler handler(path);
+		LogRecord record;
+		record.loggerName = "test";
+		record.level = LogLevel::INFO;
+		record.message = "hello\nworld";
+		handler.handle(record);
+		record.level = LogLevel::SEVERE;
+		record.message = "failure";
+		handler.handle(record);
+	}
+
+	std::ostringstream out;
+	CompressedReader(path).copyTo(out);
+	EXPECT_EQ("[INFO][test] hello\n    world\n[SEVERE][test] failure\n", out.str());
+	std::remove(path.c_str());
+}
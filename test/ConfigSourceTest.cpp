@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utl/argumentschema.h"
+#include "utl/configsource.h"
+
+using std::string;
+using utl::ArgumentSchema;
+using utl::ConfigSource;
+using utl::argr::number;
+
+
+static string tempFile(const char *name, const string &content)
+{
+	string path = "/tmp/utl_" + std::to_string(::getpid()) + "_" + name;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << content;
+	return path;
+}
+
+
+TEST(ConfigSourceTest, keyOf)
+{
+	EXPECT_EQ("log-level", ConfigSource::keyOf("--log-level="));
+	EXPECT_EQ(  "verbose", ConfigSource::keyOf("--verbose"));
+	EXPECT_EQ(         "", ConfigSource::keyOf("--"));
+}
+
+TEST(ConfigSourceTest, file)
+{
+	string path = tempFile("config", "# comment\n"
+			"  level = 5 \n"
+			"\n"
+			"name=my app\r\n"
+			"level = 6\n"
+			"broken line\n"
+			"empty =");
+
+	ConfigSource config;
+	config.setFile(path);
+	string value;
+	EXPECT_TRUE(           config.lookup("level", value));
+	EXPECT_EQ(        "5", value);
+	EXPECT_TRUE(           config.lookup("name", value));
+	EXPECT_EQ(   "my app", value);
+	EXPECT_TRUE(           config.lookup("empty", value));
+	EXPECT_EQ(         "", value);
+	EXPECT_FALSE(          config.lookup("missing", value));
+	EXPECT_TRUE(           config.lookup("level", value));
+	EXPECT_EQ(        "5", value);
+	std::remove(path.c_str());
+}
+
+TEST(ConfigSourceTest, missingFile)
+{
+	ConfigSource config;
+	config.setFile("/nonexistent/utl_config");
+	string value;
+	EXPECT_FALSE(          config.lookup("level", value));
+}
+
+TEST(ConfigSourceTest, environment)
+{
+	string path = tempFile("config_env", "log-level = 1\nname = file\n");
+	::setenv("UTLTEST_LOG_LEVEL", "2", 1);
+
+	ConfigSource config;
+	config.setFile(path);
+	string value;
+	EXPECT_TRUE(           config.lookup("log-level", value));
+	EXPECT_EQ(        "1", value);
+	config.setEnvironmentPrefix("UTLTEST_");
+	EXPECT_TRUE(           config.lookup("log-level", value));
+	EXPECT_EQ(        "2", value);
+	EXPECT_TRUE(           config.lookup("name", value));
+	EXPECT_EQ(     "file", value);
+
+	::unsetenv("UTLTEST_LOG_LEVEL");
+	std::remove(path.c_str());
+}
+
+TEST(ConfigSourceTest, schemaLayers)
+{
+	string path = tempFile("config_schema", "level = 1\nthreads = 2\nverbose = on\nname = x\n");
+	::setenv("UTLTEST_THREADS", "3", 1);
+	const char *argv[] = {"./myapp", "--level=4", "input"};
+
+	int level = 0, threads = 0, other = 0;
+	bool verbose = false;
+	ArgumentSchema schema;
+	schema.option("--level=", level, number())
+	      .option("--threads=", threads, number())
+	      .option("--other=", other, number())
+	      .flag("--verbose", verbose);
+
+	ConfigSource config;
+	config.setEnvironmentPrefix("UTLTEST_");
+	config.setFile(path);
+	EXPECT_EQ(std::vector<string>({"input"}), schema.parse(3, argv, config));
+	EXPECT_EQ(          4, level);
+	EXPECT_EQ(          3, threads);
+	EXPECT_EQ(          0, other);
+	EXPECT_TRUE(           verbose);
+
+	::unsetenv("UTLTEST_THREADS");
+	std::remove(path.c_str());
+}
+
+TEST(ConfigSourceTest, schemaInvalidValue)
+{
+	::setenv("UTLTEST_LEVEL", "high", 1);
+	const char *argv[] = {"./myapp"};
+
+	int level = 0;
+	ArgumentSchema schema;
+	schema.option("--level=", level, number());
+
+	ConfigSource config;
+	config.setEnvironmentPrefix("UTLTEST_");
+	EXPECT_THROW(          schema.parse(1, argv, config), std::runtime_error);
+	::unsetenv("UTLTEST_LEVEL");
+}
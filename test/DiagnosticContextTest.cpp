@@ -0,0 +1,126 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/bufferedlogcontext.h"
+#include "utl/log/diagnosticcontext.h"
+#include "utl/log/logger.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::BufferedLogContext;
+using utl::log::DiagnosticContext;
+using utl::log::LogLevel;
+using utl::log::Logger;
+
+
+TEST(DiagnosticContextTest, guards)
+{
+	string value;
+	EXPECT_EQ(                0, DiagnosticContext::depth());
+	{
+		DiagnosticContext::Guard request("request", "42");
+		DiagnosticContext::Guard tenant("tenant", string("acme"));
+		EXPECT_EQ(            2, DiagnosticContext::depth());
+		ASSERT_TRUE(DiagnosticContext::get("request", value));
+		EXPECT_EQ(         "42", value);
+		ASSERT_TRUE(DiagnosticContext::get("tenant", value));
+		EXPECT_EQ(       "acme", value);
+		EXPECT_FALSE(DiagnosticContext::get("user", value));
+		{
+			DiagnosticContext::Guard inner("request", "43");
+			ASSERT_TRUE(DiagnosticContext::get("request", value));
+			EXPECT_EQ(     "43", value);
+		}
+		ASSERT_TRUE(DiagnosticContext::get("request", value));
+		EXPECT_EQ(         "42", value);
+
+		string text;
+		DiagnosticContext::appendTo(text);
+		EXPECT_EQ("request=42 tenant=acme", text);
+	}
+	EXPECT_EQ(                0, DiagnosticContext::depth());
+	EXPECT_FALSE(DiagnosticContext::get("request", value));
+}
+
+TEST(DiagnosticContextTest, capacity)
+{
+	std::vector<std::unique_ptr<DiagnosticContext::Guard>> guards;
+	for (std::size_t i = 0; i < DiagnosticContext::MAX_ENTRIES + 2; ++i)
+		guards.emplace_back(new DiagnosticContext::Guard("key", "value"));
+	EXPECT_EQ(DiagnosticContext::MAX_ENTRIES, DiagnosticContext::depth());
+	while (!guards.empty())
+		guards.pop_back();
+	EXPECT_EQ(                0, DiagnosticContext::depth());
+
+	string longValue(DiagnosticContext::MAX_LENGTH, 'x');
+	{
+		DiagnosticContext::Guard first("first", "1");
+		DiagnosticContext::Guard tooLong("long", longValue);
+		DiagnosticContext::Guard second("second", "2");
+		EXPECT_EQ(            2, DiagnosticContext::depth());
+		string text;
+		DiagnosticContext::appendTo(text);
+		EXPECT_EQ("first=1 second=2", text);
+	}
+	EXPECT_EQ(                0, DiagnosticContext::depth());
+}
+
+TEST(DiagnosticContextTest, threads)
+{
+	DiagnosticContext::Guard guard("thread", "main");
+	std::thread thread([]() {
+		EXPECT_EQ(            0, DiagnosticContext::depth());
+		DiagnosticContext::Guard guard("thread", "other");
+		string value;
+		ASSERT_TRUE(DiagnosticContext::get("thread", value));
+		EXPECT_EQ(      "other", value);
+	});
+	thread.join();
+	string value;
+	ASSERT_TRUE(DiagnosticContext::get("thread", value));
+	EXPECT_EQ(           "main", value);
+}
+
+TEST(DiagnosticContextTest, records)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	logger.log(LogLevel::INFO, "none");
+	{
+		DiagnosticContext::Guard guard("request", "42");
+		logger.log(LogLevel::INFO, "one");
+		BufferedLogContext context;
+		logger.log(LogLevel::FINE, "buffered");
+		DiagnosticContext::Guard inner("step", "2");
+		logger.log(LogLevel::WARNING, "failed");
+	}
+
+	ASSERT_EQ(                4, handler->records.size());
+	EXPECT_EQ(               "", handler->records[0].context);
+	EXPECT_EQ(     "request=42", handler->records[1].context);
+	EXPECT_EQ(       "buffered", handler->records[2].message);
+	EXPECT_EQ(     "request=42", handler->records[2].context);
+	EXPECT_EQ("request=42 step=2", handler->records[3].context);
+}
+
+TEST(DiagnosticContextTest, bufferedCapacity)
+{
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+
+	DiagnosticContext::Guard guard("request", "42");
+	EXPECT_EQ(               10, DiagnosticContext::length());
+	BufferedLogContext context(LogLevel::WARNING, 20);
+	logger.log(LogLevel::FINE, "12345");
+	logger.log(LogLevel::FINE, "67890");
+	EXPECT_EQ(                1, context.size());
+	EXPECT_EQ(                1, context.getDroppedRecords());
+}
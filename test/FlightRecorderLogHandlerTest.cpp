@@ -0,0 +1,258 @@
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/flightrecorderloghandler.h"
+#include "utl/log/logger.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::FlightRecorderLogHandler;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::Logger;
+using utl::log::StackTrace;
+
+
+// Gives the tests access to the layout of the ring buffers
+class FlightRecorderLogHandlerTest : public ::testing::Test
+{
+protected:
+	typedef FlightRecorderLogHandler::Entry Entry;
+	typedef FlightRecorderLogHandler::View View;
+};
+
+
+TEST_F(FlightRecorderLogHandlerTest, dumpOnDemand)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	logger.log(LogLevel::FINE, "first");
+	logger.log(LogLevel::INFO, "second");
+	EXPECT_EQ(                0, target->records.size());
+
+	recorder->dump();
+	ASSERT_EQ(                2, target->records.size());
+	EXPECT_EQ(   LogLevel::FINE, target->records[0].level);
+	EXPECT_EQ(          "first", target->records[0].message);
+	EXPECT_EQ(   LogLevel::INFO, target->records[1].level);
+	EXPECT_EQ(         "second", target->records[1].message);
+	EXPECT_EQ(               "", target->records[1].loggerName);
+
+	// Records are only dumped once
+	recorder->dump();
+	EXPECT_EQ(                2, target->records.size());
+	logger.log(LogLevel::INFO, "third");
+	recorder->dump();
+	ASSERT_EQ(                3, target->records.size());
+	EXPECT_EQ(          "third", target->records[2].message);
+}
+
+TEST_F(FlightRecorderLogHandlerTest, dumpLevel)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	logger.log(LogLevel::INFO, "context");
+	logger.log(LogLevel::WARNING, "warning");
+	EXPECT_EQ(                0, target->records.size());
+	logger.log(LogLevel::SEVERE, "failure");
+	ASSERT_EQ(                3, target->records.size());
+	EXPECT_EQ(        "context", target->records[0].message);
+	EXPECT_EQ( LogLevel::SEVERE, target->records[2].level);
+
+	recorder->setDumpLevel(LogLevel::WARNING);
+	logger.log(LogLevel::WARNING, "warning");
+	EXPECT_EQ(                4, target->records.size());
+}
+
+TEST_F(FlightRecorderLogHandlerTest, overwriteOldest)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target, 1024);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	for (int i = 0; i < 1000; ++i)
+		logger.log(LogLevel::INFO, "message " + std::to_string(i));
+	recorder->dump();
+
+	ASSERT_LT(                0, target->records.size());
+	EXPECT_GT(             1000, target->records.size());
+	EXPECT_EQ(    "message 999", target->records.back().message);
+	for (std::size_t i = 1; i < target->records.size(); ++i) {
+		EXPECT_EQ("message " + std::to_string(1000 - target->records.size() + i),
+				target->records[i].message);
+	}
+}
+
+TEST_F(FlightRecorderLogHandlerTest, contextSiteAndStackTrace)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	static const utl::log::LogSite site = {"main.cpp", 42, "main", "failed"};
+
+	LogRecord record;
+	record.loggerName = "server";
+	record.level = LogLevel::SEVERE;
+	record.message = "failed";
+	record.context = "request=7 tenant=acme";
+	record.site = &site;
+	std::shared_ptr<StackTrace> trace = std::make_shared<StackTrace>();
+	trace->capture();
+	record.stackTrace = trace;
+	recorder->handle(record);
+
+	ASSERT_EQ(                      1, target->records.size());
+	const LogRecord &dumped = target->records[0];
+	EXPECT_EQ(               "failed", dumped.message);
+	EXPECT_EQ("request=7 tenant=acme", dumped.context);
+	EXPECT_EQ(                  &site, dumped.site);
+	ASSERT_NE(                nullptr, dumped.stackTrace);
+	EXPECT_EQ(          trace->size(), dumped.stackTrace->size());
+	for (std::size_t i = 0; i < trace->size(); ++i)
+		EXPECT_EQ(          (*trace)[i], (*dumped.stackTrace)[i]);
+}
+
+TEST_F(FlightRecorderLogHandlerTest, longMessage)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target, 256);
+	Logger logger(nullptr);
+	logger.addHandler(recorder);
+
+	logger.log(LogLevel::INFO, string(1000, 'x'));
+	recorder->dump();
+	ASSERT_EQ(                1, target->records.size());
+	EXPECT_GT(             1000, target->records[0].message.size());
+	EXPECT_EQ(string(target->records[0].message.size(), 'x'), target->records[0].message);
+}
+
+TEST_F(FlightRecorderLogHandlerTest, threads)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&logger, t]() {
+			for (int i = 0; i < 100; ++i)
+				logger.log(LogLevel::INFO, std::to_string(t) + ":" + std::to_string(i));
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	recorder->dump();
+
+	// The records of every thread keep their order
+	ASSERT_EQ(              400, target->records.size());
+	int next[4] = {0, 0, 0, 0};
+	for (const LogRecord &record : target->records) {
+		int t = record.message[0] - '0';
+		EXPECT_EQ(std::to_string(t) + ":" + std::to_string(next[t]), record.message);
+		++next[t];
+	}
+	EXPECT_EQ(                0, recorder->getDroppedRecords());
+}
+
+TEST_F(FlightRecorderLogHandlerTest, reuseRingsOfFinishedThreads)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	for (std::size_t t = 0; t < 2 * FlightRecorderLogHandler::MAX_THREADS; ++t) {
+		std::thread thread([&logger, t]() {
+			logger.log(LogLevel::INFO, std::to_string(t));
+		});
+		thread.join();
+	}
+	recorder->dump();
+
+	// The records of finished threads are kept
+	ASSERT_EQ(2 * FlightRecorderLogHandler::MAX_THREADS, target->records.size());
+	EXPECT_EQ(                "0", target->records.front().message);
+	EXPECT_EQ(                  0, recorder->getDroppedRecords());
+}
+
+TEST_F(FlightRecorderLogHandlerTest, dumpToFile)
+{
+	auto target = std::make_shared<CollectingHandler>();
+	auto recorder = std::make_shared<FlightRecorderLogHandler>(target);
+	Logger logger(nullptr);
+	logger.setLevel(LogLevel::ALL);
+	logger.addHandler(recorder);
+
+	logger.log(LogLevel::INFO, "first");
+	logger.log(LogLevel::WARNING, "second\nline");
+	LogRecord record;
+	record.level = LogLevel::INFO;
+	record.message = "third";
+	record.context = "request=7";
+	recorder->handle(record);
+
+	std::FILE *file = std::tmpfile();
+	ASSERT_NE(nullptr, file);
+	std::fflush(file);
+	recorder->dump(fileno(file));
+	std::rewind(file);
+	char buffer[256];
+	std::size_t length = std::fread(buffer, 1, sizeof(buffer), file);
+	std::fclose(file);
+
+	EXPECT_EQ("[INFO][] first\n[WARNING][] second\n    line\n[INFO][][request=7] third\n",
+			string(buffer, length));
+
+	// Dumped records are not passed to the target anymore
+	recorder->dump();
+	EXPECT_EQ(                0, target->records.size());
+}
+
+TEST_F(FlightRecorderLogHandlerTest, corruptedView)
+{
+	char data[256] = {};
+	Entry entry = {sizeof(Entry) + 5, 800, 1, 0, 5, 0, 0, nullptr};
+	std::memcpy(data, &entry, sizeof(entry));
+	std::memcpy(data + sizeof(Entry), "first", 5);
+
+	View view = {data, sizeof(data), 0, 128};
+	Entry read;
+	ASSERT_TRUE(view.peek(read));
+	EXPECT_EQ(       entry.size, read.size);
+
+	// Entries which are overwritten while they are read end the view
+	view.pos = read.size;
+	EXPECT_FALSE(view.peek(read));
+	Entry tooLarge = {200, 800, 2, 0, 200 - sizeof(Entry), 0, 0, nullptr};
+	std::memcpy(data + view.pos, &tooLarge, sizeof(tooLarge));
+	EXPECT_FALSE(view.peek(read));
+	Entry wrongLength = {sizeof(Entry) + 5, 800, 2, 1000, 5, 0, 0, nullptr};
+	std::memcpy(data + view.pos, &wrongLength, sizeof(wrongLength));
+	EXPECT_FALSE(view.peek(read));
+
+	// So do positions which do not fit into the ring
+	view.pos = 0;
+	view.end = 1000;
+	EXPECT_FALSE(view.peek(read));
+	view.end = sizeof(Entry) - 1;
+	EXPECT_FALSE(view.peek(read));
+}
@@ -0,0 +1,98 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/bufferedlogcontext.h"
+#include "utl/log/logger.h"
+#include "utl/log/loghandler.h"
+
+using std::string;
+using utl::log::BufferedLogContext;
+using utl::log::LogHandler;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::Logger;
+
+
+// Remembers the size of every batch
+class BatchHandler : public LogHandler
+{
+public:
+	std::vector<string> messages;
+	std::vector<std::size_t> batches;
+protected:
+	virtual void publish(const LogRecord &record) override {
+		messages.push_back(record.message);
+	}
+	virtual void publishBatch(const LogRecord *records, std::size_t count) override {
+		batches.push_back(count);
+		LogHandler::publishBatch(records, count);
+	}
+};
+
+static LogRecord makeRecord(const LogLevel &level, const string &message)
+{
+	LogRecord record;
+	record.level = level;
+	record.message = message;
+	return record;
+}
+
+
+TEST(LogHandlerTest, handleBatch)
+{
+	BatchHandler handler;
+	handler.setLevel(LogLevel::INFO);
+	LogRecord records[] = {
+		makeRecord(LogLevel::FINE, "0"),
+		makeRecord(LogLevel::INFO, "1"),
+		makeRecord(LogLevel::SEVERE, "2"),
+		makeRecord(LogLevel::FINE, "3"),
+		makeRecord(LogLevel::FINE, "4"),
+		makeRecord(LogLevel::WARNING, "5")
+	};
+	handler.handleBatch(records, 6);
+
+	ASSERT_EQ(                3, handler.messages.size());
+	EXPECT_EQ(              "1", handler.messages[0]);
+	EXPECT_EQ(              "2", handler.messages[1]);
+	EXPECT_EQ(              "5", handler.messages[2]);
+	ASSERT_EQ(                2, handler.batches.size());
+	EXPECT_EQ(                2, handler.batches[0]);
+	EXPECT_EQ(                1, handler.batches[1]);
+
+	handler.handleBatch(records, 1);
+	handler.handleBatch(records, 0);
+	EXPECT_EQ(                2, handler.batches.size());
+}
+
+TEST(LogHandlerTest, flushInBatches)
+{
+	Logger parent(nullptr);
+	parent.setLevel(LogLevel::ALL);
+	auto parentHandler = std::make_shared<BatchHandler>();
+	parent.addHandler(parentHandler);
+	std::shared_ptr<Logger> parentPtr(&parent, [](Logger*) {});
+	Logger first(parentPtr), second(parentPtr);
+	auto handler = std::make_shared<BatchHandler>();
+	first.addHandler(handler);
+
+	{
+		BufferedLogContext context;
+		first.log(LogLevel::FINE, "a");
+		first.log(LogLevel::FINE, "b");
+		second.log(LogLevel::FINE, "c");
+		first.log(LogLevel::FINE, "d");
+		context.flush();
+	}
+
+	ASSERT_EQ(                3, handler->messages.size());
+	ASSERT_EQ(                2, handler->batches.size());
+	EXPECT_EQ(                2, handler->batches[0]);
+	EXPECT_EQ(                1, handler->batches[1]);
+	EXPECT_EQ(                4, parentHandler->messages.size());
+	ASSERT_EQ(                3, parentHandler->batches.size());
+	EXPECT_EQ(                2, parentHandler->batches[0]);
+}
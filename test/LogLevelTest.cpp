@@ -0,0 +1,56 @@
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/loglevel.h"
+
+using std::string;
+using utl::log::LogLevel;
+
+
+static string print(LogLevel level)
+{
+	std::ostringstream stream;
+	stream << level;
+	return stream.str();
+}
+
+static_assert(std::is_trivially_copyable<LogLevel>::value, "LogLevel should be trivially copyable");
+static_assert(static_cast<int>(LogLevel(42)) == 42, "LogLevel should be usable in constant expressions");
+static_assert(LogLevel(100) < LogLevel(200), "LogLevel should be usable in constant expressions");
+
+
+TEST(LogLevelTest, predefinedNames)
+{
+	EXPECT_STREQ("FINEST",  LogLevel::FINEST.getName());
+	EXPECT_STREQ("INFO",    LogLevel::INFO.getName());
+	EXPECT_STREQ("SEVERE",  LogLevel(1000).getName());
+	EXPECT_EQ(nullptr,      LogLevel::ALL.getName());
+	EXPECT_EQ("WARNING",    print(LogLevel::WARNING));
+	EXPECT_EQ("123",        print(LogLevel(123)));
+}
+
+TEST(LogLevelTest, registerName)
+{
+	EXPECT_EQ(nullptr, LogLevel(201).getName());
+	EXPECT_TRUE(LogLevel::registerName(201, "TRACE"));
+	EXPECT_STREQ("TRACE", LogLevel(201).getName());
+	EXPECT_EQ("TRACE",    print(LogLevel(201)));
+
+	// The first name is kept, predefined names cannot be changed
+	EXPECT_TRUE(LogLevel::registerName(201, "TRACE"));
+	EXPECT_FALSE(LogLevel::registerName(201, "DEBUG"));
+	EXPECT_FALSE(LogLevel::registerName(800, "NOTICE"));
+	EXPECT_EQ("INFO", print(LogLevel::INFO));
+
+	LogLevel audit(1100, "AUDIT");
+	EXPECT_EQ("AUDIT", print(audit));
+	EXPECT_EQ("AUDIT", print(LogLevel(1100)));
+	EXPECT_NO_THROW(LogLevel(1100, "AUDIT"));
+	EXPECT_THROW(LogLevel(1100, "SECURITY"), std::invalid_argument);
+	EXPECT_THROW(LogLevel(800, "NOTICE"),    std::invalid_argument);
+}
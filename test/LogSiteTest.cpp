@@ -0,0 +1,122 @@
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#define UTL_LOGGER LogSiteTest
+#include "utl/logging.h"
+#include "utl/log/bufferedlogcontext.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::BufferedLogContext;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::LogSite;
+using utl::log::Logger;
+
+
+class LogSiteTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override {
+		handler = std::make_shared<CollectingHandler>();
+		Logger::get("LogSiteTest").setLevel(LogLevel::ALL);
+		Logger::get("LogSiteTest").addHandler(handler);
+	}
+	virtual void TearDown() override {
+		Logger::get("LogSiteTest").removeHandler(handler);
+	}
+
+	std::shared_ptr<CollectingHandler> handler;
+};
+
+
+TEST_F(LogSiteTest, macros)
+{
+	int line = __LINE__ + 1;
+	utl_info("value %d", 42);
+	utl_fine("plain");
+
+	ASSERT_EQ(                2, handler->records.size());
+	const LogRecord &record = handler->records[0];
+	EXPECT_EQ(       "value 42", record.message);
+	ASSERT_NE(          nullptr, record.site);
+	EXPECT_NE(          nullptr, std::strstr(record.site->file, "LogSiteTest.cpp"));
+	EXPECT_EQ(             line, record.site->line);
+	EXPECT_STREQ(    "TestBody", record.site->function);
+	EXPECT_STREQ(    "value %d", record.site->format);
+	EXPECT_EQ(   LogLevel::INFO, record.level);
+	EXPECT_EQ(   LogLevel::FINE, handler->records[1].level);
+	EXPECT_NE(record.site, handler->records[1].site);
+}
+
+TEST_F(LogSiteTest, sameSite)
+{
+	for (int i = 0; i < 3; ++i)
+		utl_warning("loop %d", i);
+	ASSERT_EQ(                3, handler->records.size());
+	EXPECT_EQ(handler->records[0].site, handler->records[2].site);
+	EXPECT_EQ(        "loop 2", handler->records[2].message);
+}
+
+TEST_F(LogSiteTest, nonLiteralFormat)
+{
+	string message = "dynamic";
+	utl_info(message);
+	const char *format = "pointer %d";
+	utl_info(format, 1);
+
+	ASSERT_EQ(                2, handler->records.size());
+	EXPECT_EQ(        "dynamic", handler->records[0].message);
+	EXPECT_EQ(          nullptr, handler->records[0].site->format);
+	EXPECT_EQ(      "pointer 1", handler->records[1].message);
+	EXPECT_EQ(          nullptr, handler->records[1].site->format);
+}
+
+TEST_F(LogSiteTest, filtered)
+{
+	Logger::get("LogSiteTest").setLevel(LogLevel::INFO);
+	utl_fine("filtered %d", 1);
+	EXPECT_EQ(                0, handler->records.size());
+
+	if (handler->records.empty())
+		utl_info("statement");
+	else
+		utl_info("other");
+	EXPECT_EQ(                1, handler->records.size());
+}
+
+TEST_F(LogSiteTest, buffered)
+{
+	{
+		BufferedLogContext context;
+		utl_fine("held back");
+		utl_severe("failed");
+	}
+	ASSERT_EQ(                2, handler->records.size());
+	ASSERT_NE(          nullptr, handler->records[0].site);
+	EXPECT_STREQ(   "held back", handler->records[0].site->format);
+	EXPECT_EQ( LogLevel::SEVERE, handler->records[1].level);
+}
+
+TEST_F(LogSiteTest, runtimeLevel)
+{
+	bool verbose = false;
+	utl_log(LogLevel(950), "custom");
+	utl_log(verbose ? LogLevel::FINE : LogLevel::INFO, "conditional");
+	LogLevel level = LogLevel::WARNING;
+	for (int i = 0; i < 2; ++i) {
+		utl_log(level, "variable");
+		level = LogLevel::SEVERE;
+	}
+
+	ASSERT_EQ(                4, handler->records.size());
+	EXPECT_EQ(    LogLevel(950), handler->records[0].level);
+	EXPECT_EQ(   LogLevel::INFO, handler->records[1].level);
+	EXPECT_EQ(LogLevel::WARNING, handler->records[2].level);
+	EXPECT_EQ( LogLevel::SEVERE, handler->records[3].level);
+	EXPECT_EQ(handler->records[2].site, handler->records[3].site);
+}
@@ -0,0 +1,94 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logger.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::Logger;
+
+
+// Restores an unbounded registry without unused loggers
+class LoggerTest : public ::testing::Test
+{
+protected:
+	virtual void SetUp() override {
+		Logger::sweep();
+		size = Logger::getRegistrySize();
+	}
+	virtual void TearDown() override {
+		Logger::setRegistryLimit(0);
+		Logger::sweep();
+	}
+	std::size_t size;
+};
+
+
+TEST_F(LoggerTest, sweep)
+{
+	std::shared_ptr<Logger> held = Logger::getP("test.sweep.held");
+	Logger::get("test.sweep.configured").setLevel(LogLevel::FINE);
+	Logger::get("test.sweep.unused");
+	EXPECT_EQ(size + 3, Logger::getRegistrySize());
+
+	EXPECT_EQ(            1u, Logger::sweep());
+	EXPECT_EQ(      size + 2, Logger::getRegistrySize());
+	EXPECT_EQ(          held, Logger::getP("test.sweep.held"));
+	EXPECT_EQ(LogLevel::FINE, Logger::get("test.sweep.configured").getLevel());
+
+	held.reset();
+	EXPECT_EQ(            1u, Logger::sweep());
+	EXPECT_EQ(      size + 1, Logger::getRegistrySize());
+}
+
+TEST_F(LoggerTest, registryLimit)
+{
+	Logger::setRegistryLimit(size + 4);
+	for (int i = 0; i < 100; ++i)
+		Logger::get("test.limit." + std::to_string(i));
+	EXPECT_EQ(size + 4, Logger::getRegistrySize());
+	EXPECT_EQ(size + 4, Logger::getRegistryLimit());
+
+	// Referenced and configured loggers are kept beyond the limit
+	std::vector<std::shared_ptr<Logger>> held;
+	for (int i = 0; i < 6; ++i)
+		held.push_back(Logger::getP("test.held." + std::to_string(i)));
+	EXPECT_EQ(size + 6, Logger::getRegistrySize());
+	held.clear();
+	Logger::get("test.limit.last");
+	EXPECT_EQ(size + 4, Logger::getRegistrySize());
+}
+
+TEST_F(LoggerTest, leastRecentlyUsed)
+{
+	Logger::setRegistryLimit(size + 2);
+	std::shared_ptr<Logger> first = Logger::getP("test.lru.first");
+	Logger *firstAddress = first.get();
+	first.reset();
+	Logger::get("test.lru.second");
+	// Using the first logger again makes the second one the oldest
+	EXPECT_EQ(firstAddress, &Logger::get("test.lru.first"));
+	Logger::get("test.lru.third");
+
+	EXPECT_EQ(    size + 2, Logger::getRegistrySize());
+	EXPECT_EQ(firstAddress, Logger::getP("test.lru.first").get());
+}
+
+TEST_F(LoggerTest, evictedLoggerIsRecreated)
+{
+	auto handler = std::make_shared<CollectingHandler>();
+	Logger::getRoot().addHandler(handler);
+	Logger::get("test.recreated").log(LogLevel::INFO, "first");
+	Logger::sweep();
+	Logger::get("test.recreated").log(LogLevel::INFO, "second");
+	Logger::getRoot().removeHandler(handler);
+
+	ASSERT_EQ(              2u, handler->records.size());
+	EXPECT_EQ("test.recreated", handler->records[0].loggerName);
+	EXPECT_EQ("test.recreated", handler->records[1].loggerName);
+}
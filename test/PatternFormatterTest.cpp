@@ -0,0 +1,120 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logrecord.h"
+#include "utl/log/logsite.h"
+#include "utl/log/patternformatter.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::LogSite;
+using utl::log::PatternFormatter;
+
+
+static LogRecord makeRecord(const LogLevel &level, const string &name, const string &message)
+{
+	LogRecord record;
+	record.level = level;
+	record.loggerName = name;
+	record.message = message;
+	return record;
+}
+
+
+TEST(PatternFormatterTest, defaultPattern)
+{
+	PatternFormatter formatter;
+	LogRecord record = makeRecord(LogLevel::INFO, "app", "first\nsecond");
+	EXPECT_EQ("[INFO][app] first\n    second", formatter.format(record));
+
+	record.context = "request=42";
+	EXPECT_EQ("[INFO][app][request=42] first\n    second", formatter.format(record));
+}
+
+TEST(PatternFormatterTest, conversions)
+{
+	static const LogSite site = {"main.cpp", 12, "run", "msg"};
+	PatternFormatter formatter("%n: %l %% %F:%L %M() %m");
+	LogRecord record = makeRecord(LogLevel::WARNING, "app", "msg");
+	EXPECT_EQ("app: WARNING % ?:? ?() msg", formatter.format(record));
+	record.site = &site;
+	EXPECT_EQ("app: WARNING % main.cpp:12 run() msg", formatter.format(record));
+}
+
+TEST(PatternFormatterTest, cachedPrefixes)
+{
+	PatternFormatter formatter("<%l|%n> %m");
+	string out;
+	formatter.format(makeRecord(LogLevel::INFO, "a", "1"), out);
+	formatter.format(makeRecord(LogLevel::SEVERE, "a", "2"), out);
+	formatter.format(makeRecord(LogLevel::INFO, "b", "3"), out);
+	formatter.format(makeRecord(LogLevel::INFO, "a", "4"), out);
+	EXPECT_EQ("<INFO|a> 1<SEVERE|a> 2<INFO|b> 3<INFO|a> 4", out);
+
+	for (std::size_t i = 0; i < 2 * PatternFormatter::MAX_CACHED_LOGGERS; ++i) {
+		string name = "logger" + std::to_string(i);
+		EXPECT_EQ("<INFO|" + name + "> x", formatter.format(makeRecord(LogLevel::INFO, name, "x")));
+	}
+}
+
+TEST(PatternFormatterTest, threadCaches)
+{
+	PatternFormatter first("<%l|%n> %m");
+	PatternFormatter second("%n/%l %m");
+	std::vector<std::thread> threads;
+	std::vector<int> failures(4, 0);
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&, t]() {
+			for (int i = 0; i < 1000; ++i) {
+				string name = "logger" + std::to_string((i * 7 + t) % 20);
+				LogRecord record = makeRecord(LogLevel::INFO, name, "x");
+				if (first.format(record) != "<INFO|" + name + "> x")
+					++failures[t];
+				if (second.format(record) != name + "/INFO x")
+					++failures[t];
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	EXPECT_EQ(std::vector<int>(4, 0), failures);
+}
+
+TEST(PatternFormatterTest, colors)
+{
+	PatternFormatter formatter("[%l][%n] %m", true);
+	EXPECT_EQ("[\x1b[32mINFO\x1b[0m][\x1b[1mapp\x1b[0m] msg",
+			formatter.format(makeRecord(LogLevel::INFO, "app", "msg")));
+	EXPECT_EQ("[\x1b[31mSEVERE\x1b[0m][\x1b[1mapp\x1b[0m] msg",
+			formatter.format(makeRecord(LogLevel::SEVERE, "app", "msg")));
+}
+
+TEST(PatternFormatterTest, dateAndThread)
+{
+	PatternFormatter iso("%d %t|%m");
+	string out = iso.format(makeRecord(LogLevel::INFO, "app", "msg"));
+	// like 2024-01-31T12:34:56.789
+	ASSERT_LT(               23, out.size());
+	EXPECT_EQ(              '-', out[4]);
+	EXPECT_EQ(              'T', out[10]);
+	EXPECT_EQ(              '.', out[19]);
+	EXPECT_EQ(              ' ', out[23]);
+	EXPECT_EQ(         "|msg", out.substr(out.size() - 4));
+
+	PatternFormatter custom("%d{%Y} %m");
+	out = custom.format(makeRecord(LogLevel::INFO, "app", "msg"));
+	EXPECT_EQ(                8, out.size());
+	EXPECT_EQ(          " msg", out.substr(4));
+}
+
+TEST(PatternFormatterTest, invalidPattern)
+{
+	EXPECT_THROW(PatternFormatter("%q"), std::invalid_argument);
+	EXPECT_THROW(PatternFormatter("%m %"), std::invalid_argument);
+	EXPECT_THROW(PatternFormatter("%d{%Y"), std::invalid_argument);
+}
@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utl/arguments.h"
+#include "utl/responsefiles.h"
+
+using std::string;
+using utl::Arguments;
+using utl::ResponseFiles;
+
+
+static string tempFile(const char *name, const string &content)
+{
+	string path = "/tmp/utl_" + std::to_string(::getpid()) + "_" + name;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << content;
+	return path;
+}
+
+static std::vector<string> expand(std::vector<string> input)
+{
+	std::vector<const char*> argv;
+	for (const string &arg : input)
+		argv.push_back(arg.c_str());
+	ResponseFiles files(static_cast<int>(argv.size()), argv.data());
+	EXPECT_EQ(nullptr, files.argv()[files.argc()]);
+	return std::vector<string>(files.argv(), files.argv() + files.argc());
+}
+
+
+TEST(ResponseFilesTest, noFiles)
+{
+	std::vector<string> expected = {"./myapp", "-x", "@", "arg"};
+	EXPECT_EQ(expected, expand({"./myapp", "-x", "@", "arg"}));
+}
+
+TEST(ResponseFilesTest, missingFile)
+{
+	std::vector<string> expected = {"./myapp", "@/nonexistent/utl_args"};
+	EXPECT_EQ(expected, expand({"./myapp", "@/nonexistent/utl_args"}));
+}
+
+TEST(ResponseFilesTest, tokens)
+{
+	string path = tempFile("tokens", "-a  --test=5\n"
+			"# a comment --no\n"
+			"'single quoted' \"double \\\"quoted\\\"\" \n"
+			"esc\\ aped '' \"'\" last");
+
+	std::vector<string> expected = {"./myapp", "first", "-a", "--test=5",
+			"single quoted", "double \"quoted\"", "esc aped", "", "'", "last", "end"};
+	EXPECT_EQ(expected, expand({"./myapp", "first", "@" + path, "end"}));
+	std::remove(path.c_str());
+}
+
+TEST(ResponseFilesTest, emptyFile)
+{
+	string path = tempFile("empty", "");
+
+	std::vector<string> expected = {"./myapp", "x"};
+	EXPECT_EQ(expected, expand({"./myapp", "@" + path, "x"}));
+	std::remove(path.c_str());
+}
+
+TEST(ResponseFilesTest, nested)
+{
+	string inner = tempFile("inner", "b c");
+	string outer = tempFile("outer", "a @" + inner + " d\n");
+
+	std::vector<string> expected = {"./myapp", "a", "b", "c", "d", "b", "c"};
+	EXPECT_EQ(expected, expand({"./myapp", "@" + outer, "@" + inner}));
+	std::remove(inner.c_str());
+	std::remove(outer.c_str());
+}
+
+TEST(ResponseFilesTest, cycle)
+{
+	string first = "/tmp/utl_" + std::to_string(::getpid()) + "_cycle1";
+	string second = tempFile("cycle2", "y @" + first);
+	tempFile("cycle1", "x @" + second);
+
+	EXPECT_THROW(     expand({"./myapp", "@" + first}), std::runtime_error);
+	std::remove(first.c_str());
+	std::remove(second.c_str());
+}
+
+TEST(ResponseFilesTest, unterminatedQuote)
+{
+	string path = tempFile("quote", "a \"b c");
+
+	EXPECT_THROW(     expand({"./myapp", "@" + path}), std::runtime_error);
+	std::remove(path.c_str());
+}
+
+TEST(ResponseFilesTest, withArguments)
+{
+	string path = tempFile("args", "--test=5 -v file");
+	string arg1 = "@" + path;
+	const char *argv[] = {"./myapp", arg1.c_str()};
+
+	ResponseFiles files(2, argv);
+	Arguments args(files.argc(), files.argv());
+	args.registerOption("--test=", 1);
+
+	string param;
+	EXPECT_EQ(          1, args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(        "5", param);
+	EXPECT_EQ(        'v', args.getNextOption());
+	EXPECT_EQ(          0, args.getNextOption());
+	EXPECT_TRUE(          args.getNextArgument(param));
+	EXPECT_EQ(     "file", param);
+	EXPECT_FALSE(         args.getNextArgument(param));
+	std::remove(path.c_str());
+}
+
+TEST(ResponseFilesTest, manyTokens)
+{
+	string content;
+	for (int i = 0; i < 100000; ++i)
+		content += "arg" + std::to_string(i) + (i % 10 ? ' ' : '\n');
+	string path = tempFile("many", content);
+
+	std::vector<string> result = expand({"./myapp", "@" + path});
+	ASSERT_EQ(100001u, result.size());
+	EXPECT_EQ(    "arg0", result[1]);
+	EXPECT_EQ("arg99999", result[100000]);
+	std::remove(path.c_str());
+}
@@ -0,0 +1,96 @@
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logger.h"
+#include "utl/log/scopedtimer.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::Logger;
+using utl::log::ScopedTimer;
+using utl::log::TraceRecorder;
+
+
+TEST(ScopedTimerTest, logsElapsedTime)
+{
+	Logger logger(nullptr);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	{
+		ScopedTimer timer(logger, LogLevel::INFO, "work");
+		EXPECT_TRUE(timer.isEnabled());
+	}
+	ASSERT_EQ(                1, handler->records.size());
+	EXPECT_EQ(   LogLevel::INFO, handler->records[0].level);
+	EXPECT_EQ(                0, handler->records[0].message.find("work took "));
+}
+
+TEST(ScopedTimerTest, disabledLevel)
+{
+	Logger logger(nullptr);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+	TraceRecorder trace;
+
+	{
+		ScopedTimer timer(logger, LogLevel::FINE, "work",
+				ScopedTimer::Clock::duration::zero(), &trace);
+		EXPECT_FALSE(timer.isEnabled());
+		EXPECT_EQ(ScopedTimer::Clock::duration::zero(), timer.elapsed());
+	}
+	EXPECT_EQ(                0, handler->records.size());
+	EXPECT_EQ(                0, trace.size());
+}
+
+TEST(ScopedTimerTest, threshold)
+{
+	Logger logger(nullptr);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+	TraceRecorder trace;
+
+	{
+		ScopedTimer timer(logger, LogLevel::INFO, "fast",
+				std::chrono::hours(1), &trace);
+	}
+	EXPECT_EQ(                0, handler->records.size());
+	EXPECT_EQ(                1, trace.size());
+}
+
+TEST(ScopedTimerTest, stopOnce)
+{
+	Logger logger(nullptr);
+	auto handler = std::make_shared<CollectingHandler>();
+	logger.addHandler(handler);
+
+	{
+		ScopedTimer timer(logger, LogLevel::INFO, "work");
+		timer.stop();
+		timer.stop();
+	}
+	EXPECT_EQ(                1, handler->records.size());
+}
+
+TEST(ScopedTimerTest, chromeTrace)
+{
+	Logger logger(nullptr);
+	TraceRecorder trace;
+	{
+		ScopedTimer timer(logger, LogLevel::INFO, "outer \"span\"",
+				std::chrono::hours(1), &trace);
+	}
+
+	std::ostringstream json;
+	trace.writeJson(json);
+	string str = json.str();
+	EXPECT_EQ(                0, str.find("{\"traceEvents\":[\n{\"name\":\"outer \\\"span\\\"\",\"ph\":\"X\",\"ts\":"));
+	EXPECT_NE(string::npos, str.find("\"dur\":"));
+	EXPECT_NE(string::npos, str.find("],\"displayTimeUnit\":\"ms\"}"));
+}
@@ -0,0 +1,211 @@
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logrecord.h"
+#include "utl/log/sharedmemorylogcollector.h"
+#include "utl/log/sharedmemoryloghandler.h"
+#include "utl/log/sharedmemoryring.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::SharedMemoryLogCollector;
+using utl::log::SharedMemoryLogHandler;
+using utl::log::SharedMemoryRing;
+
+
+static string tempPath(const char *name)
+{
+	return "/tmp/utl_" + std::to_string(::getpid()) + "_" + name;
+}
+
+static LogRecord record(const LogLevel &level, const string &msg)
+{
+	LogRecord rec;
+	rec.loggerName = "test";
+	rec.level = level;
+	rec.message = msg;
+	return rec;
+}
+
+
+TEST(SharedMemoryLogTest, ringRoundtrip)
+{
+	string path = tempPath("roundtrip.ring");
+	SharedMemoryRing producer(path, 4096);
+	SharedMemoryRing consumer(path);
+	ASSERT_TRUE(producer.good());
+	ASSERT_TRUE(consumer.good());
+	EXPECT_EQ(producer.getCapacity(), consumer.getCapacity());
+	EXPECT_EQ(::getpid(),             consumer.getPid());
+
+	LogRecord rec = record(LogLevel::WARNING, "first");
+	rec.context = "req=7";
+	EXPECT_TRUE(producer.write(rec));
+	EXPECT_TRUE(producer.write(record(LogLevel::INFO, "second")));
+
+	std::vector<SharedMemoryRing::Record> records;
+	EXPECT_EQ(2u, consumer.read(records));
+	ASSERT_EQ(2u, records.size());
+	EXPECT_EQ("test",           records[0].record.loggerName);
+	EXPECT_EQ(LogLevel::WARNING, records[0].record.level);
+	EXPECT_EQ("first",          records[0].record.message);
+	EXPECT_EQ("req=7",          records[0].record.context);
+	EXPECT_EQ("second",         records[1].record.message);
+	EXPECT_LE(records[0].time,  records[1].time);
+	EXPECT_TRUE(consumer.empty());
+	::unlink(path.c_str());
+}
+
+TEST(SharedMemoryLogTest, wrapAround)
+{
+	string path = tempPath("wrap.ring");
+	SharedMemoryRing producer(path, 4096);
+	SharedMemoryRing consumer(path);
+	string msg(300, 'x');
+
+	std::vector<SharedMemoryRing::Record> records;
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_TRUE(producer.write(record(LogLevel::INFO, msg + std::to_string(i))));
+		if (i % 5 == 4) {
+			EXPECT_EQ(5u, consumer.read(records));
+		}
+	}
+	ASSERT_EQ(100u, records.size());
+	EXPECT_EQ(msg + "0",  records[0].record.message);
+	EXPECT_EQ(msg + "99", records[99].record.message);
+	EXPECT_EQ(0u,         producer.getDroppedRecords());
+	::unlink(path.c_str());
+}
+
+TEST(SharedMemoryLogTest, dropWhenFull)
+{
+	string path = tempPath("full.ring");
+	SharedMemoryRing producer(path, 4096);
+	SharedMemoryRing consumer(path);
+	string msg(500, 'x');
+
+	int written = 0;
+	for (int i = 0; i < 20; ++i)
+		written += producer.write(record(LogLevel::INFO, msg)) ? 1 : 0;
+	EXPECT_GT(written, 0);
+	EXPECT_LT(written, 20);
+	EXPECT_EQ(static_cast<std::size_t>(20 - written), consumer.getDroppedRecords());
+
+	std::vector<SharedMemoryRing::Record> records;
+	EXPECT_EQ(static_cast<std::size_t>(written), consumer.read(records));
+	EXPECT_TRUE(producer.write(record(LogLevel::INFO, msg)));
+	::unlink(path.c_str());
+}
+
+TEST(SharedMemoryLogTest, threads)
+{
+	string path = tempPath("threads.ring");
+	SharedMemoryRing producer(path, 1024 * 1024);
+	SharedMemoryRing consumer(path);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&producer, t]() {
+			for (int i = 0; i < 1000; ++i)
+				producer.write(record(LogLevel::INFO, std::to_string(t)));
+		});
+	}
+	std::vector<SharedMemoryRing::Record> records;
+	while (records.size() < 4000 && consumer.getDroppedRecords() == 0)
+		consumer.read(records);
+	for (std::thread &thread : threads)
+		thread.join();
+	consumer.read(records);
+
+	int counts[4] = {};
+	for (const SharedMemoryRing::Record &r : records)
+		++counts[std::atoi(r.record.message.c_str())];
+	for (int t = 0; t < 4; ++t)
+		EXPECT_EQ(1000, counts[t]);
+	::unlink(path.c_str());
+}
+
+TEST(SharedMemoryLogTest, collectorMergesByTime)
+{
+	string directory = tempPath("merge");
+	std::vector<SharedMemoryLogCollector::Record> records;
+	{
+		SharedMemoryLogHandler first(directory);
+		SharedMemoryLogHandler second(directory);
+		ASSERT_TRUE(first.good());
+		ASSERT_TRUE(second.good());
+		first.publish(record(LogLevel::INFO, "1"));
+		second.publish(record(LogLevel::INFO, "2"));
+		first.publish(record(LogLevel::INFO, "3"));
+
+		SharedMemoryLogCollector collector(directory);
+		EXPECT_EQ(3u, collector.collect(records));
+		EXPECT_EQ(2u, collector.getRingCount());
+
+		second.publish(record(LogLevel::INFO, "4"));
+		EXPECT_EQ(1u, collector.collect(records));
+	}
+	ASSERT_EQ(4u, records.size());
+	EXPECT_EQ("1", records[0].record.message);
+	EXPECT_EQ("2", records[1].record.message);
+	EXPECT_EQ("3", records[2].record.message);
+	EXPECT_EQ("4", records[3].record.message);
+
+	// Closed rings are removed once they are drained
+	SharedMemoryLogCollector collector(directory);
+	records.clear();
+	EXPECT_EQ(0u, collector.collect(records));
+	EXPECT_EQ(0u, collector.getRingCount());
+	EXPECT_EQ(0,  ::rmdir(directory.c_str()));
+}
+
+TEST(SharedMemoryLogTest, collectorDelay)
+{
+	string directory = tempPath("delay");
+	SharedMemoryLogCollector collector(directory, std::chrono::hours(1));
+	std::vector<SharedMemoryLogCollector::Record> records;
+	{
+		SharedMemoryLogHandler handler(directory);
+		handler.publish(record(LogLevel::INFO, "late"));
+		EXPECT_EQ(0u, collector.collect(records));
+		EXPECT_EQ(1u, collector.collectAll(records));
+	}
+
+	// The closed ring is removed once it is drained
+	EXPECT_EQ(0u, collector.collectAll(records));
+	EXPECT_EQ(0u, collector.getRingCount());
+	EXPECT_EQ(0,  ::rmdir(directory.c_str()));
+}
+
+TEST(SharedMemoryLogTest, crashedProducer)
+{
+	string directory = tempPath("crash");
+	pid_t pid = ::fork();
+	ASSERT_GE(pid, 0);
+	if (pid == 0) {
+		// Leave without closing the ring, like a crash
+		SharedMemoryLogHandler *handler = new SharedMemoryLogHandler(directory);
+		handler->publish(record(LogLevel::SEVERE, "last words"));
+		::_exit(0);
+	}
+	int status;
+	::waitpid(pid, &status, 0);
+
+	SharedMemoryLogCollector collector(directory);
+	std::vector<SharedMemoryLogCollector::Record> records;
+	EXPECT_EQ(1u, collector.collect(records));
+	ASSERT_EQ(1u, records.size());
+	EXPECT_EQ("last words",     records[0].record.message);
+	EXPECT_EQ(LogLevel::SEVERE, records[0].record.level);
+	EXPECT_EQ(pid,              records[0].pid);
+	EXPECT_EQ(0u,               collector.getRingCount());
+	EXPECT_EQ(0,                ::rmdir(directory.c_str()));
+}
@@ -0,0 +1,179 @@
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logrecord.h"
+#include "utl/log/socketloghandler.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::LogRecord;
+using utl::log::SocketLogHandler;
+
+
+// Local stand-in for the collector daemon
+class Listener
+{
+public:
+	Listener(const string &path, int type) : path(path) {
+		sockaddr_un addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		std::strcpy(addr.sun_path, path.c_str());
+		::unlink(path.c_str());
+		fd = ::socket(AF_UNIX, type, 0);
+		::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+		if (type == SOCK_STREAM)
+			::listen(fd, 4);
+	}
+	~Listener() {
+		if (conn >= 0)
+			::close(conn);
+		::close(fd);
+		::unlink(path.c_str());
+	}
+	string receive() {
+		int src = fd;
+		if (conn >= 0) {
+			src = conn;
+		} else {
+			int type; socklen_t len = sizeof(type);
+			::getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len);
+			if (type == SOCK_STREAM)
+				src = conn = ::accept(fd, nullptr, nullptr);
+		}
+		char buf[4096];
+		ssize_t n = ::recv(src, buf, sizeof(buf), MSG_DONTWAIT);
+		return n > 0 ? string(buf, n) : string();
+	}
+private:
+	string path;
+	int fd, conn = -1;
+};
+
+static string socketPath(const char *name)
+{
+	return "/tmp/utl_" + std::to_string(::getpid()) + "_" + name;
+}
+
+static LogRecord record(const LogLevel &level, const string &msg)
+{
+	LogRecord rec;
+	rec.loggerName = "test";
+	rec.level = level;
+	rec.message = msg;
+	return rec;
+}
+
+
+TEST(SocketLogHandlerTest, streamBatch)
+{
+	string path = socketPath("stream");
+	Listener listener(path, SOCK_STREAM);
+	SocketLogHandler handler(path);
+	handler.setBatchSize(2);
+
+	EXPECT_TRUE(                  handler.isConnected());
+	handler.handle(record(LogLevel::INFO, "first"));
+	EXPECT_EQ(                 1, handler.getPendingRecords());
+	handler.handle(record(LogLevel::INFO, "second"));
+	EXPECT_EQ(                 0, handler.getPendingRecords());
+	EXPECT_EQ("[INFO][test] first\n[INFO][test] second\n", listener.receive());
+}
+
+TEST(SocketLogHandlerTest, streamHandleBatch)
+{
+	string path = socketPath("streamHandleBatch");
+	Listener listener(path, SOCK_STREAM);
+	SocketLogHandler handler(path);
+	handler.setBatchSize(8);
+	handler.setLevel(LogLevel::INFO);
+
+	LogRecord records[] = {
+		record(LogLevel::INFO, "first"),
+		record(LogLevel::FINE, "filtered"),
+		record(LogLevel::SEVERE, "second")
+	};
+	handler.handleBatch(records, 3);
+	EXPECT_EQ(                 0, handler.getPendingRecords());
+	EXPECT_EQ("[INFO][test] first\n[SEVERE][test] second\n", listener.receive());
+}
+
+TEST(SocketLogHandlerTest, datagramFlushLevel)
+{
+	string path = socketPath("dgram");
+	Listener listener(path, SOCK_DGRAM);
+	SocketLogHandler handler(path, SocketLogHandler::Type::DATAGRAM);
+
+	handler.handle(record(LogLevel::INFO, "a\nb"));
+	handler.handle(record(LogLevel::SEVERE, "c"));
+	EXPECT_EQ(                 0, handler.getPendingRecords());
+	EXPECT_EQ( "[INFO][test] a\n    b\n", listener.receive());
+	EXPECT_EQ("[SEVERE][test] c\n", listener.receive());
+	EXPECT_EQ(                "", listener.receive());
+}
+
+TEST(SocketLogHandlerTest, datagramTooLarge)
+{
+	string path = socketPath("large");
+	Listener listener(path, SOCK_DGRAM);
+	SocketLogHandler handler(path, SocketLogHandler::Type::DATAGRAM);
+	handler.setBufferLimit(4 * 1024 * 1024);
+
+	handler.handle(record(LogLevel::INFO, "before"));
+	handler.handle(record(LogLevel::INFO, string(1024 * 1024, 'x')));
+	handler.handle(record(LogLevel::SEVERE, "after"));
+	EXPECT_EQ(                 0, handler.getPendingRecords());
+	EXPECT_EQ(                 1, handler.getDroppedRecords());
+	EXPECT_TRUE(                  handler.isConnected());
+	EXPECT_EQ(  "[INFO][test] before\n", listener.receive());
+	EXPECT_EQ("[SEVERE][test] after\n", listener.receive());
+}
+
+TEST(SocketLogHandlerTest, reconnect)
+{
+	string path = socketPath("reconnect");
+	SocketLogHandler handler(path, SocketLogHandler::Type::DATAGRAM);
+	EXPECT_FALSE(                 handler.isConnected());
+
+	handler.handle(record(LogLevel::SEVERE, "buffered"));
+	EXPECT_EQ(                 1, handler.getPendingRecords());
+	EXPECT_FALSE(                 handler.flush());
+
+	{
+		Listener listener(path, SOCK_DGRAM);
+		EXPECT_TRUE(              handler.flush());
+		EXPECT_EQ("[SEVERE][test] buffered\n", listener.receive());
+	}
+
+	// collector restarted
+	Listener listener(path, SOCK_DGRAM);
+	handler.handle(record(LogLevel::SEVERE, "lost connection"));
+	handler.handle(record(LogLevel::SEVERE, "reconnected"));
+	EXPECT_EQ(                 0, handler.getPendingRecords());
+	EXPECT_EQ("[SEVERE][test] lost connection\n", listener.receive());
+	EXPECT_EQ("[SEVERE][test] reconnected\n", listener.receive());
+}
+
+TEST(SocketLogHandlerTest, bufferLimit)
+{
+	string path = socketPath("limit");
+	SocketLogHandler handler(path, SocketLogHandler::Type::DATAGRAM);
+	handler.setBufferLimit(40);
+
+	handler.handle(record(LogLevel::INFO, "one"));
+	handler.handle(record(LogLevel::INFO, "two"));
+	handler.handle(record(LogLevel::INFO, "three"));
+	EXPECT_EQ(                 2, handler.getPendingRecords());
+	EXPECT_EQ(                 1, handler.getDroppedRecords());
+
+	Listener listener(path, SOCK_DGRAM);
+	EXPECT_TRUE(                  handler.flush());
+	EXPECT_EQ(  "[INFO][test] two\n", listener.receive());
+	EXPECT_EQ("[INFO][test] three\n", listener.receive());
+}
@@ -0,0 +1,74 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "utl/log/logger.h"
+#include "utl/log/patternformatter.h"
+#include "utl/log/stacktrace.h"
+
+#include "CollectingHandler.h"
+
+using std::string;
+using utl::log::LogLevel;
+using utl::log::Logger;
+using utl::log::PatternFormatter;
+using utl::log::StackTrace;
+
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+
+__attribute__((noinline)) static void recurse(StackTrace &trace, int depth)
+{
+	if (depth > 0)
+		recurse(trace, depth - 1);
+	else
+		trace.capture(0, 8);
+	__asm__ __volatile__("");
+}
+
+
+TEST(StackTraceTest, capture)
+{
+	StackTrace trace;
+	EXPECT_TRUE(trace.empty());
+	EXPECT_EQ("", trace.toString());
+
+	recurse(trace, 20);
+	EXPECT_EQ(8u, trace.size());
+	// all frames are in recurse()
+	for (std::size_t i = 1; i < trace.size(); ++i)
+		EXPECT_EQ(trace[1], trace[i]);
+
+	string text = trace.toString();
+	EXPECT_EQ(0u, text.find("#0 0x"));
+	EXPECT_NE(string::npos, text.find("\n#7 0x"));
+	EXPECT_EQ(string::npos, text.find("\n#8"));
+	EXPECT_NE('\n', text.back());
+}
+
+TEST(StackTraceTest, loggerLevel)
+{
+	auto handler = std::make_shared<CollectingHandler>();
+	Logger logger(nullptr);
+	logger.addHandler(handler);
+	EXPECT_EQ(LogLevel::OFF, logger.getStackTraceLevel());
+
+	logger.log(LogLevel::SEVERE, "no trace");
+	logger.setStackTraceLevel(LogLevel::SEVERE);
+	logger.log(LogLevel::WARNING, "no trace");
+	logger.log(LogLevel::SEVERE, "trace");
+
+	ASSERT_EQ(3u, handler->records.size());
+	EXPECT_EQ(nullptr, handler->records[0].stackTrace);
+	EXPECT_EQ(nullptr, handler->records[1].stackTrace);
+	ASSERT_NE(nullptr, handler->records[2].stackTrace);
+	EXPECT_FALSE(handler->records[2].stackTrace->empty());
+
+	PatternFormatter formatter("%m");
+	string text = formatter.format(handler->records[2]);
+	EXPECT_EQ(0u, text.find("trace\n    #0 0x"));
+	EXPECT_EQ("no trace", formatter.format(handler->records[1]));
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Collector for utl::log::SharedMemoryLogHandler.
+ *
+ * Usage: utl_logcollector [--pattern=<pattern>] [--interval=<ms>] [--delay=<ms>]
+ *                         [--once] <directory>
+ *
+ * Drains the rings of all processes which log into <directory> and writes
+ * the records ordered by time to the standard output. Every line starts with
+ * the time and the process id of the record, followed by the record formatted
+ * with the pattern. With --once, the rings are drained a single time.
+ * Otherwise, the collector runs until it receives SIGINT or SIGTERM.
+ */
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utl/arguments.h"
+#include "utl/log/patternformatter.h"
+#include "utl/log/sharedmemorylogcollector.h"
+
+#define OPT_PATTERN  256
+#define OPT_INTERVAL 257
+#define OPT_DELAY    258
+#define OPT_ONCE     259
+
+using utl::log::PatternFormatter;
+using utl::log::SharedMemoryLogCollector;
+
+static volatile std::sig_atomic_t running = 1;
+
+static void stop(int);
+static void write(const std::vector<SharedMemoryLogCollector::Record> &records,
+		const PatternFormatter &formatter);
+
+
+int main(int argc, char *argv[])
+{
+	utl::Arguments args(argc, argv);
+	args.registerOption("--pattern=", OPT_PATTERN);
+	args.registerOption("--interval=", OPT_INTERVAL);
+	args.registerOption("--delay=", OPT_DELAY);
+	args.registerOption("--once", OPT_ONCE);
+
+	std::string pattern = PatternFormatter::DEFAULT_PATTERN;
+	unsigned int interval = 100;
+	unsigned int delay = 0;
+	bool once = false;
+
+	while (int opt = args.getNextOption()) {
+		bool valid = true;
+		switch (opt) {
+		case OPT_PATTERN:
+			valid = args.getNextArgument(pattern);
+			break;
+		case OPT_INTERVAL:
+			valid = args.getNextArgument(interval);
+			break;
+		case OPT_DELAY:
+			valid = args.getNextArgument(delay);
+			break;
+		case OPT_ONCE:
+			once = true;
+			break;
+		default:
+			std::cerr << "Unknown option: " << args.getOptionName() << std::endl;
+			return EXIT_FAILURE;
+		}
+		if (!valid) {
+			std::cerr << "Invalid or missing argument for " << args.getOptionName()
+					<< "." << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::string directory;
+	if (args.getArgumentsLeft() != 1 || !args.getNextArgument(directory)) {
+		std::cerr << "Usage: " << argv[0] << " [--pattern=<pattern>] [--interval=<ms>]"
+				" [--delay=<ms>] [--once] <directory>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::unique_ptr<PatternFormatter> formatter;
+	try {
+		formatter.reset(new PatternFormatter(pattern));
+	} catch (const std::invalid_argument &e) {
+		std::cerr << "Invalid pattern: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::signal(SIGINT, stop);
+	std::signal(SIGTERM, stop);
+
+	SharedMemoryLogCollector collector(directory, std::chrono::milliseconds(delay));
+	std::vector<SharedMemoryLogCollector::Record> records;
+	while (running && !once) {
+		collector.collect(records);
+		write(records, *formatter);
+		records.clear();
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+	}
+	collector.collectAll(records);
+	write(records, *formatter);
+	return EXIT_SUCCESS;
+}
+
+
+void stop(int)
+{
+	running = 0;
+}
+
+/**
+ * Writes the records to the standard output, prefixed with the time and the
+ * process id.
+ */
+void write(const std::vector<SharedMemoryLogCollector::Record> &records,
+		const PatternFormatter &formatter)
+{
+	std::string line;
+	for (const SharedMemoryLogCollector::Record &r : records) {
+		std::time_t seconds = static_cast<std::time_t>(r.time / 1000000000);
+		std::tm tm;
+		::localtime_r(&seconds, &tm);
+		char prefix[64];
+		std::size_t length = std::strftime(prefix, sizeof(prefix), "%Y-%m-%dT%H:%M:%S", &tm);
+		std::snprintf(prefix + length, sizeof(prefix) - length, ".%06ld %d ",
+				static_cast<long>(r.time % 1000000000 / 1000), r.pid);
+
+		line = prefix;
+		formatter.format(r.record, line);
+		line += '\n';
+		std::fwrite(line.data(), 1, line.size(), stdout);
+	}
+	std::fflush(stdout);
+}